@@ -9,6 +9,7 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/FEM/Controller/TimeIntegration.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 #include "../../src/FEM/Equation/General.h"
@@ -42,37 +43,35 @@ int main() {
 	double theta = 0.5;			//	FDM parameter for time
 	double k = 0.0;				//	Diffusion coefficient
 
-	for(int t = 0; t < 100; t++){
-		std::cout << "t = " << t << std::endl;	
+	ThetaIntegrator<double> integrator = ThetaIntegrator<double>(nodetoglobal, theta, false);
+	for (auto element : elements) {
+		Vector<double> ge = CenterOfGravity(x, element);
+		double ax = -(ge(1) - 0.5);
+		double ay = (ge(0) - 0.5);
 
-		LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
-		std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
+		std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+		Matrix<double> M;
+		Mass<double, ShapeFunction3Triangle, Gauss1Triangle>(M, nodetoelement, element, { 0 }, x);
+		Matrix<double> MS;
+		MassSUPG<double, ShapeFunction3Triangle, Gauss1Triangle>(MS, nodetoelement, element, { 0 }, x, ax, ay, k);
+		Matrix<double> A;
+		Advection<double, ShapeFunction3Triangle, Gauss1Triangle>(A, nodetoelement, element, { 0 }, x, ax, ay);
+		Matrix<double> D;
+		Diffusion<double, ShapeFunction3Triangle, Gauss1Triangle>(D, nodetoelement, element, { 0 }, x, k);
+		Matrix<double> AS;
+		AdvectionSUPG<double, ShapeFunction3Triangle, Gauss1Triangle>(AS, nodetoelement, element, { 0 }, x, ax, ay, k);
+		Matrix<double> Ce = M + MS;
+		Matrix<double> Ke = A + D + AS;
+		integrator.Assembling(Ce, Ke, nodetoelement, element);
+	}
+	integrator.Initialize(T, dt);
 
-		for (auto element : elements) {
-			Vector<double> ge = CenterOfGravity(x, element);
-			double ax = -(ge(1) - 0.5);
-			double ay = (ge(0) - 0.5);
+	std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
 
-			std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-			Matrix<double> M;
-			Mass<double, ShapeFunction3Triangle, Gauss1Triangle>(M, nodetoelement, element, { 0 }, x);
-			Matrix<double> MS;
-			MassSUPG<double, ShapeFunction3Triangle, Gauss1Triangle>(MS, nodetoelement, element, { 0 }, x, ax, ay, k);
-			Matrix<double> A;
-			Advection<double, ShapeFunction3Triangle, Gauss1Triangle>(A, nodetoelement, element, { 0 }, x, ax, ay);
-			Matrix<double> D;
-			Diffusion<double, ShapeFunction3Triangle, Gauss1Triangle>(D, nodetoelement, element, { 0 }, x, k);
-			Matrix<double> AS;
-			AdvectionSUPG<double, ShapeFunction3Triangle, Gauss1Triangle>(AS, nodetoelement, element, { 0 }, x, ax, ay, k);
-			Vector<double> Te =ElementVector(T, nodetoelement, element);
-			Matrix<double> Ke = (M + MS)/dt + theta*(A + D + AS);
-			Vector<double> Fe = ((M + MS)/dt - (1.0 - theta)*(A + D + AS))*Te;
-			Assembling(K, F, T, Ke, Fe, nodetoglobal, nodetoelement, element);
-		}
+	for(int t = 0; t < 100; t++){
+		std::cout << "t = " << t << std::endl;	
 
-		CSR<double> Kmod = CSR<double>(K);
-		std::vector<double> result = BiCGSTAB(Kmod, F, 100000, 1.0e-10);
-		Disassembling(T, result, nodetoglobal);
+		integrator.Step(T, F);
 		
 		std::ofstream fout(model_path + "result" + std::to_string(t) + ".vtk");
 		MakeHeadderToVTK(fout);
@@ -9,6 +9,7 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/FEM/Controller/TimeIntegration.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 #include "../../src/FEM/Equation/General.h"
@@ -45,38 +46,57 @@ int main() {
 
 	double dt = 0.001;
 	double theta = 0.5;
+	double tmax = 0.5;
 
-	for(int t = 0; t < 500; t++){
-		std::cout << "t = " << t << std::endl;
+	ThetaIntegrator<double> integrator = ThetaIntegrator<double>(nodetoglobal, theta);
+	for (auto element : elements) {
+		std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+		Matrix<double> Ke;
+		HeatTransfer<double, ShapeFunction3Triangle, Gauss1Triangle>(Ke, nodetoelement, element, { 0 }, x, 1.0, 1.0);
+		Matrix<double> Ce;
+		HeatCapacity<double, ShapeFunction3Triangle, Gauss1Triangle>(Ce, nodetoelement, element, { 0 }, x, 1.0, 1.0, 1.0);
+		integrator.Assembling(Ce, Ke, nodetoelement, element);
+	}
+	integrator.Initialize(T, dt);
+
+	std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
+
+	//----------Time step loop with adaptive time step----------
+	TimeStepController<double> controller = TimeStepController<double>(dt, 1.0e-5, 0.05, 1.0e-3, theta);
+	double time = 0.0;
+	int output = 0;
+	while(time < tmax) {
+		controller.LimitTimeStep(tmax - time);
+		if(controller.GetTimeStep() != integrator.GetTimeStep()) {
+			integrator.SetTimeStep(controller.GetTimeStep());
+		}
+		dt = integrator.GetTimeStep();
+		std::cout << "time = " << time << "\tdt = " << dt;
+
+		std::vector<Vector<double> > Tprev = T;
+		integrator.Trial(T, F);
 
-		LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
-		std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
-		
-        for (auto element : elements) {
-            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-			Matrix<double> Ke;
-			HeatTransfer<double, ShapeFunction3Triangle, Gauss1Triangle>(Ke, nodetoelement, element, { 0 }, x, 1.0, 1.0);
-			Matrix<double> Ce;
-			HeatCapacity<double, ShapeFunction3Triangle, Gauss1Triangle>(Ce, nodetoelement, element, { 0 }, x, 1.0, 1.0, 1.0);
-			Vector<double> Te = ElementVector(T, nodetoelement, element);
-			Matrix<double> Ae = Ce/dt + Ke*theta;
-			Vector<double> be = (Ce/dt - Ke*(1.0 - theta))*Te; 
-			Assembling(K, F, T, Ae, nodetoglobal, nodetoelement, element);
-            Assembling(F, be, nodetoglobal, nodetoelement, element);
+		//----------Reject step and retry with smaller dt----------
+		if(!controller.Check(T, Tprev)) {
+			std::cout << "\trejected" << std::endl;
+			integrator.Reject(T);
+			continue;
 		}
+		std::cout << std::endl;
 
-		CSR<double> Kmod = CSR<double>(K);
-		std::vector<double> result = ScalingCG(Kmod, F, 100000, 1.0e-10);
-        Disassembling(T, result, nodetoglobal);
+		integrator.Accept();
+		time += dt;
 	
-		std::ofstream fout("sample/heattransfer/result" + std::to_string(t) + ".vtk");
+		std::ofstream fout("sample/heattransfer/result" + std::to_string(output) + ".vtk");
 		MakeHeadderToVTK(fout);
 		AddPointsToVTK(x, fout);
 		AddElementToVTK(elements, fout);
 		AddElementTypes(std::vector<int>(elements.size(), 5), fout);
 		AddPointScalers(T, "T", fout, true);
 		fout.close();
+		output++;
 	}
+	std::cout << "accepted = " << controller.ACCEPTED() << "\trejected = " << controller.REJECTED() << std::endl;
 
 	return 0;
 }
\ No newline at end of file
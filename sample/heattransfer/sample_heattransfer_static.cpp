@@ -45,11 +45,11 @@ int main() {
 	LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);			
 	std::vector<double> F = std::vector<double>(KDEGREE, 0.0);		
 
-	for(auto element : elements) {
-		std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-		Matrix<double> Ke;
-		HeatTransfer<double, ShapeFunction3Triangle, Gauss1Triangle>(Ke, nodetoelement, element, { 0 }, x, 5.0, 1.0);
-		Assembling(K, F, T, Ke, nodetoglobal, nodetoelement, element);
+	std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+	std::vector<Matrix<double> > Kes;
+	HeatTransferBatch<double, ShapeFunction3Triangle, Gauss1Triangle>(Kes, nodetoelement, elements, 0, elements.size(), { 0 }, x, 5.0, 1.0);
+	for(int i = 0; i < elements.size(); i++) {
+		Assembling(K, F, T, Kes[i], nodetoglobal, nodetoelement, elements[i]);
 	}
 
 	CSR<double> Kmod = CSR<double>(K);
@@ -9,7 +9,8 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
-#include "../../src/LinearAlgebra/Solvers/CG.h"
+#include "../../src/FEM/Controller/TimeIntegration.h"
+#include "../../src/LinearAlgebra/Solvers/GMRES.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 #include "../../src/FEM/Equation/General.h"
 
@@ -44,19 +45,27 @@ int main() {
 	
     double rho = 1.0;
     double mu = 1.0/1000.0;
-    int tmax = 10000;
+    double tmax = 100.0;
     double dt = 0.01;
     double theta = 0.5;
+    double courant = 5.0;       //  Maximum Courant number
     SetDirichlet(up, nodetoglobal, ufixed0);
     SetDirichlet(up, nodetoglobal, ufixed1);
 	int KDEGREE = Renumbering(nodetoglobal);
+    GMRESWorkspace<double> work = GMRESWorkspace<double>(KDEGREE, 50);      //  Reused in every time step
 
     std::vector<Vector<double> > ubar = std::vector<Vector<double> >(x.size(), Vector<double>(2));      //  Advection velocity
 
 
-    //----------Time step loop----------
-    for(int t = 0; t <= tmax; t++) {
-        std::cout << "t=" << t << std::endl;
+    //----------Time step loop with adaptive time step----------
+    TimeStepController<double> controller = TimeStepController<double>(dt, 0.5*dt, 0.5, 1.0e-3, theta);
+    std::vector<Vector<double> > u = std::vector<Vector<double> >(x.size(), Vector<double>(2));
+    double time = 0.0;
+    int output = 0;
+    while(time < tmax) {
+        controller.LimitTimeStep(GetCFLTimeStep<double, ShapeFunction4Square, Gauss4Square>(x, elements, ubar, courant));
+        dt = controller.GetTimeStep();
+        std::cout << "time=" << time << "\tdt=" << dt << std::endl;
 
         LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);			//  System stiffness matrix
         std::vector<double> F = std::vector<double>(KDEGREE, 0.0);		//  System load vector
@@ -78,20 +87,30 @@ int main() {
         }
 
         CSR<double> Kmod = CSR<double>(K);
-        std::vector<double> result = BiCGSTAB2(Kmod, F, 100000, 1.0e-10);
-        Disassembling(up, result, nodetoglobal);
+        CSR<double> Mmod = ILU0(Kmod);
+        std::vector<double> result = ILU0GMRES(Kmod, Mmod, F, 100000, 1.0e-10, work);
+        std::vector<Vector<double> > upnext = up;
+        Disassembling(upnext, result, nodetoglobal);
 
-        std::vector<Vector<double> > u = std::vector<Vector<double> >(x.size());
+        std::vector<Vector<double> > unext = std::vector<Vector<double> >(x.size());
         std::vector<double> p = std::vector<double>(x.size(), 0.0);
         for(int i = 0; i < x.size(); i++){
-            u[i] = up[i].Segment(0, 2);
-            p[i] = up[i](2);
+            unext[i] = upnext[i].Segment(0, 2);
+            p[i] = upnext[i](2);
         }
 
+        //----------Reject step and retry with smaller dt----------
+        if(!controller.Check(unext, u)) {
+            continue;
+        }
+
+        up = upnext;
+        u = unext;
         ubar = u;
+        time += dt;
 
-        if(t%100 == 0) {
-            std::ofstream fout("sample/navierstokes/result" + std::to_string(t/100) + ".vtk");
+        if(time >= output) {
+            std::ofstream fout("sample/navierstokes/result" + std::to_string(output) + ".vtk");
             MakeHeadderToVTK(fout);
             AddPointsToVTK(x, fout);
             AddElementToVTK(elements, fout);
@@ -99,8 +118,10 @@ int main() {
             AddPointVectors(u, "u", fout, true);
             AddPointScalers(p, "p", fout, false);
             fout.close();
+            output++;
         }
     }
+    std::cout << "accepted=" << controller.ACCEPTED() << "\trejected=" << controller.REJECTED() << std::endl;
     
 	return 0;
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/FEM/Controller/TimeIntegration.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 #include "../../src/FEM/Equation/General.h"
@@ -70,29 +71,26 @@ int main() {
 	int KDEGREEP = Renumbering(nodetoglobalp);
 
 
+    //----------Make lumped mass----------
+    ExplicitIntegrator<double> integrator = ExplicitIntegrator<double>(nodetoglobalvu, dt);
+    for (int i = 0; i < elements.size(); i++) {
+        std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+        Matrix<double> Me;
+        NavierStokesDecoupledLumpedMass<double, ShapeFunction4Square, Gauss4Square>(Me, nodetoelement, elements[i], { 0, 1 }, x, rho);
+        integrator.Assembling(Me, nodetoelement, elements[i]);
+    }
+
+
     //----------Time step loop----------
     for(int t = 0; t < tmax; t++) {
         std::cout << "t=" << t << std::endl;
 
         //----------Get auxiliary velocity----------
-        LILCSR<double> Kv = LILCSR<double>(KDEGREEVU, KDEGREEVU);		//  System stiffness matrix
         std::vector<double> Fv = std::vector<double>(KDEGREEVU, 0.0);	//  System load vector
-
-        for (int i = 0; i < elements.size(); i++) {
-            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-            Matrix<double> Me;
-            NavierStokesDecoupledLumpedMass<double, ShapeFunction4Square, Gauss4Square>(Me, nodetoelement, elements[i], { 0, 1 }, x, rho);
-            Assembling(Kv, Fv, v, Me, nodetoglobalvu, nodetoelement, elements[i]);
-            Vector<double> Fe;
-            NavierStokesAuxiliaryVelocity<double, ShapeFunction4Square, Gauss4Square>(Fe, nodetoelement, elements[i], { 0, 1 }, x, u, rho, mu);
-            Fe = Me*ElementVector(u, nodetoelement, elements[i]) + dt*Fe;
-            Assembling(Fv, Fe, nodetoglobalvu, nodetoelement, elements[i]);
-        }
-
-        CSR<double> Kvmod = CSR<double>(Kv);
-        std::vector<double> diagonalmassv = GetDiagonal(Kvmod);
-        std::vector<double> resultv = Scaling(diagonalmassv, Fv);
-        Disassembling(v, resultv, nodetoglobalvu);
+        AssemblingParallel(Fv, nodetoglobalvu, elements, [&](Vector<double>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, int _i) {
+            NavierStokesAuxiliaryVelocity<double, ShapeFunction4Square, Gauss4Square>(_Fe, _nodetoelement, elements[_i], { 0, 1 }, x, u, rho, mu);
+        });
+        integrator.ForwardEuler(v, u, Fv);
 
 
         //----------Solve Pressure-Poisson equation----------
@@ -114,24 +112,11 @@ int main() {
 
 
         //----------Update next step velocity----------
-        LILCSR<double> Ku = LILCSR<double>(KDEGREEVU, KDEGREEVU);		//  System stiffness matrix
         std::vector<double> Fu = std::vector<double>(KDEGREEVU, 0.0);	//  System load vector
-
-        for (int i = 0; i < elements.size(); i++) {
-            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-            Matrix<double> Me;
-            NavierStokesDecoupledLumpedMass<double, ShapeFunction4Square, Gauss4Square>(Me, nodetoelement, elements[i], { 0, 1 }, x, rho);
-            Assembling(Ku, Fu, u, Me, nodetoglobalvu, nodetoelement, elements[i]);
-            Vector<double> Fe;
-            NavierStokesNextstepVelocity<double, ShapeFunction4Square, Gauss4Square>(Fe, nodetoelement, elements[i], { 0, 1 }, x, v, p, rho);
-            Fe = Me*ElementVector(v, nodetoelement, elements[i]) + dt*Fe;
-            Assembling(Fu, Fe, nodetoglobalvu, nodetoelement, elements[i]);
-        }
-
-        CSR<double> Kumod = CSR<double>(Ku);
-        std::vector<double> diagonalmassu = GetDiagonal(Kumod);
-        std::vector<double> resultu = Scaling(diagonalmassu, Fu);
-        Disassembling(u, resultu, nodetoglobalvu);    
+        AssemblingParallel(Fu, nodetoglobalvu, elements, [&](Vector<double>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, int _i) {
+            NavierStokesNextstepVelocity<double, ShapeFunction4Square, Gauss4Square>(_Fe, _nodetoelement, elements[_i], { 0, 1 }, x, v, p, rho);
+        });
+        integrator.ForwardEuler(u, v, Fu);
         
 
         //----------Export result----------
@@ -9,6 +9,7 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/FEM/Controller/ElementGeometryCache.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 #include "../../src/FEM/Equation/General.h"
@@ -40,6 +41,7 @@ int main() {
 	int KDEGREE = Renumbering(nodetoglobal);
 
     std::vector<Vector<double> > ubar = std::vector<Vector<double> >(x.size(), Vector<double>(2));      //  Advection velocity
+    ElementGeometryCache<double, ShapeFunction4Square, Gauss9Square> geometry = ElementGeometryCache<double, ShapeFunction4Square, Gauss9Square>(x, elementsp);    //  Mesh is fixed through time steps
 
 
     //----------Time step loop----------
@@ -52,7 +54,7 @@ int main() {
         for (int i = 0; i < elementsu.size(); i++) {
             std::vector<std::vector<std::pair<int, int> > > nodetoelementu, nodetoelementp;
             Matrix<double> Ke, Me, Ce;
-            NavierStokesStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, ubar, rho, mu);
+            NavierStokesStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, geometry, i, ubar, rho, mu);
             NavierStokesConsistentMass<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Me, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, rho);
             ContinuityStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ce, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x);
             Matrix<double> Ae = Me/dt + theta*Ke + Ce;
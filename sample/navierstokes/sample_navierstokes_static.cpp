@@ -10,7 +10,9 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/FEM/Controller/JacobianFreeNewtonKrylov.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
+#include "../../src/LinearAlgebra/Solvers/BlockPreconditioner.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 
 
@@ -29,6 +31,19 @@ int main() {
     std::vector<std::pair<std::pair<int, int>, double> > ufixed;
 	ImportDirichletFromCSV(ufixed, model_path + "Dirichlet.csv");
 
+    //----------Fix pressure of nodes which are not vertices of pressure elements----------
+    std::vector<bool> ispressurenode = std::vector<bool>(x.size(), false);
+    for (auto& elementp : elementsp) {
+        for (auto i : elementp) {
+            ispressurenode[i] = true;
+        }
+    }
+    for (int i = 0; i < x.size(); i++) {
+        if (!ispressurenode[i]) {
+            ufixed.push_back({ { i, 2 }, 0.0 });
+        }
+    }
+
     std::vector<Vector<double> > up = std::vector<Vector<double> >(x.size(), Vector<double>(3));
 	std::vector<std::vector<int> > nodetoglobal = std::vector<std::vector<int> >(x.size(), std::vector<int>(3, 0));
 	
@@ -40,7 +55,19 @@ int main() {
         ufixedi.second *= 1.0/(double)kmax;
     }
     SetDirichlet(up, nodetoglobal, ufixed0);
-	int KDEGREE = Renumbering(nodetoglobal);
+	int KDEGREE = Renumbering(nodetoglobal, { { 0, 1 }, { 2 } });     //  Pressure is numbered after velocity for block preconditioner
+    int UDEGREE = CountDegree(nodetoglobal, { 0, 1 });
+
+    //----------Pressure mass matrix/mu for Schur complement approximation----------
+    LILCSR<double> S = LILCSR<double>(KDEGREE, KDEGREE);
+    std::vector<double> dummy = std::vector<double>(KDEGREE, 0.0);
+    for (int i = 0; i < elementsu.size(); i++) {
+        std::vector<std::vector<std::pair<int, int> > > nodetoelementu, nodetoelementp;
+        Matrix<double> Me;
+        StokesPressureMass<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Me, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, 1.0/mu);
+        Assembling(S, dummy, up, Me, nodetoglobal, { nodetoelementu, nodetoelementp }, { elementsu[i], elementsp[i] });
+    }
+    CSR<double> Smod = SubMatrix(CSR<double>(S), UDEGREE, KDEGREE, UDEGREE, KDEGREE);
 
     //----------Get initial result with Stokes equation----------
     LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE); 
@@ -49,15 +76,24 @@ int main() {
     for (int i = 0; i < elementsu.size(); i++) {
         std::vector<std::vector<std::pair<int, int> > > nodetoelementu, nodetoelementp;
         Matrix<double> Ke;
-        Stokes<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, mu);
+        StokesStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, mu);
         Assembling(K, F, up, Ke, nodetoglobal, { nodetoelementu, nodetoelementp }, { elementsu[i], elementsp[i] });
     }
 
     CSR<double> Kmod = CSR<double>(K);
-    std::vector<double> result = CG(Kmod, F, 100000, 1.0e-10);
+    CSR<double> Sstokes = Smod*(-1.0);
+    BlockTriangularPreconditioner<double> P = BlockTriangularPreconditioner<double>(Kmod, UDEGREE, Sstokes);
+    std::vector<double> result = FGMRES(Kmod, P, F, 100, 100000, 1.0e-10);
     Disassembling(up, result, nodetoglobal);
     
-    //----------Incremental step loop----------
+    //----------Merge velocity and pressure nodes of each element for parallel residual assembling----------
+    std::vector<std::vector<int> > elementsup = elementsu;
+    for (int i = 0; i < elementsu.size(); i++) {
+        elementsup[i].insert(elementsup[i].end(), elementsp[i].begin(), elementsp[i].end());
+    }
+
+    //----------Incremental step loop with Jacobian-free Newton-Krylov----------
+    JacobianFreeNewtonKrylov<double> jfnk = JacobianFreeNewtonKrylov<double>(100, 1.0e-5);
     for(int k = 1; k < kmax; k++) {
         std::cout << "k=" << k;
 
@@ -67,36 +103,42 @@ int main() {
         }
         SetDirichlet(up, nodetoglobal, ufixedk);
 
-        //----------Newton-Raphson loop----------
-        for(int l = 0; l < 100; l++) {
-            LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);			//System stiffness matrix
-            std::vector<double> R = std::vector<double>(KDEGREE, 0.0);		//Residual load vector
-            std::vector<Vector<double> > dup = std::vector<Vector<double> >(x.size(), Vector<double>(3));
-
-            for (int i = 0; i < elementsu.size(); i++) {
-                std::vector<std::vector<std::pair<int, int> > > nodetoelementu, nodetoelementp;
-                Matrix<double> Ke;
-                Vector<double> Qe;
-                NavierStokesTangent<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, Qe, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, up, rho, mu);
-                Assembling(K, R, dup, Ke, nodetoglobal, { nodetoelementu, nodetoelementp }, { elementsu[i], elementsp[i] });
-                Assembling(R, Qe, nodetoglobal, nodetoelementu, elementsu[i]);
-                Assembling(R, Qe, nodetoglobal, nodetoelementp, elementsp[i]);  
-            }
-  
-            double normR = std::inner_product(R.begin(), R.end(), R.begin(), 0.0);
-            std::cout << "\t\tl = " << l << "\tR Norm = " << normR << std::endl;
-            if (normR < 1.0e-10) {
-                std::cout << "\tConvergence at l = " << l << "\tR Norm = " << normR << std::endl;
-                break;
-            }
-            
-            CSR<double> Kmod = CSR<double>(K);
-            std::vector<double> result = BiCGSTAB2(Kmod, R, 100000, 1.0e-10);
-            Disassembling(dup, result, nodetoglobal);
-            for(int i = 0; i < x.size(); i++){
-                up[i] += dup[i];
-            }
-        }
+        bool isconverged = jfnk.Solve(
+            //----------Residual----------
+            [&](std::vector<double>& _R) {
+                _R = std::vector<double>(KDEGREE, 0.0);
+                AssemblingParallel(_R, nodetoglobal, elementsup, [&](Vector<double>& _Re, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, int _i) {
+                    std::vector<std::vector<std::pair<int, int> > > nodetoelementp;
+                    NavierStokesResidual<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(_Re, _nodetoelement, elementsu[_i], nodetoelementp, elementsp[_i], { 0, 1, 2 }, x, up, rho, mu);
+                    _nodetoelement.insert(_nodetoelement.end(), nodetoelementp.begin(), nodetoelementp.end());
+                });
+            },
+            //----------Block preconditioner of Picard (Oseen) matrix----------
+            [&]() {
+                LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
+                std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
+                for (int i = 0; i < elementsu.size(); i++) {
+                    std::vector<std::vector<std::pair<int, int> > > nodetoelementu, nodetoelementp;
+                    Matrix<double> Ke, Ce;
+                    NavierStokesStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, up, rho, mu);
+                    ContinuityStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ce, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x);
+                    Ke += Ce;
+                    Assembling(K, F, up, Ke, nodetoglobal, { nodetoelementu, nodetoelementp }, { elementsu[i], elementsp[i] });
+                }
+                CSR<double> Kmod = CSR<double>(K);
+                return BlockTriangularPreconditioner<double>(Kmod, UDEGREE, Smod);
+            },
+            //----------Update----------
+            [&](const std::vector<double>& _dup) {
+                std::vector<Vector<double> > dup = std::vector<Vector<double> >(x.size(), Vector<double>(3));
+                Disassembling(dup, _dup, nodetoglobal);
+                for(int i = 0; i < x.size(); i++){
+                    up[i] += dup[i];
+                }
+            },
+            1.0
+        );
+        std::cout << "\tl = " << jfnk.ITERATIONS() << "\tR Norm = " << jfnk.NORM() << "\tResiduals = " << jfnk.RESIDUALS() << (isconverged ? "" : "\tNot converged") << std::endl;
     }
 
     std::vector<Vector<double> > u = std::vector<Vector<double> >(x.size());
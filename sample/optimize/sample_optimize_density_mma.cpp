@@ -9,11 +9,14 @@
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
+#include "../../src/FEM/Controller/SolutionExtrapolation.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 #include "../../src/Optimize/Solver/MMA.h"
 #include "../../src/Optimize/Filter/HeavisideFilter.h"
+#include "../../src/Optimize/Filter/NeighborSearch.h"
 #include "../../src/PrePost/Mesher/SquareMesh.h"
 #include "../../src/FEM/Equation/General.h"
+#include "../../src/Optimize/Material/SIMP.h"
 
 
 using namespace PANSFEM2;
@@ -46,21 +49,13 @@ int main() {
         cg[i] = CenterOfGravity(x, elements[i]);
     }
 
-    //----------Get neighbor elements list and weight----------
-    std::vector<std::vector<int> > neighbors = std::vector<std::vector<int> >(elements.size(), std::vector<int>());
-    std::vector<std::vector<double> > w = std::vector<std::vector<double> >(elements.size(), std::vector<double>());
+    //----------Get filter matrix from neighbor elements----------
     double R = 1.5;
-    for(int i = 0; i < elements.size(); i++){
-        for(int j = 0; j < elements.size(); j++){
-            if((cg[i] - cg[j]).Norm() <= R){
-                neighbors[i].push_back(j);
-                w[i].push_back((R - (cg[i] - cg[j]).Norm())/R);
-            }
-        }
-    }
+    NeighborSearch<double> neighborsearch = NeighborSearch<double>(cg, R);
+    CSR<double> H = FilterMatrix(neighborsearch, R);
 
     //----------Initialize Heaviside filter class----------
-    HeavisideFilter<double> filter = HeavisideFilter<double>(elements.size(), neighbors, w);
+    HeavisideFilter<double> filter = HeavisideFilter<double>(H);
 
 	//----------Initialize design variables----------
 	std::vector<double> s = std::vector<double>(elements.size(), 0.5);
@@ -77,6 +72,11 @@ int main() {
 
     double beta = 0.5;
 
+    //----------Make reference stiffness matrices----------
+    SIMP<double> simp = SIMP<double>(x, elements, [&](Matrix<double>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        PlaneStrainStiffness<double, ShapeFunction4Square, Gauss4Square>(_Ke, _nodetoelement, _element, { 0, 1 }, x, 1.0, Poisson, 1.0);
+    }, E0, E1, p);
+
     MMA<double> optimizer = MMA<double>(s.size(), 1, 1.0,
 		std::vector<double>(1, 0.0),
 		std::vector<double>(1, 10000.0),
@@ -84,6 +84,8 @@ int main() {
 		std::vector<double>(s.size(), 0.01), std::vector<double>(s.size(), 1.0));
 	optimizer.SetParameters(1.0e-5, 0.1, 0.2, 0.5, 0.7, 1.2, 1.0e-6);
 			
+    SolutionExtrapolation<double> extrapolation = SolutionExtrapolation<double>(ExtrapolationMethod::POD, 4);     //Initial guess of CG from displacements of previous designs
+			
 	//----------Optimize loop----------
 	for(int k = 0; k < 500; k++){
 		std::cout << "\nk = " << k << "\t";
@@ -123,47 +125,23 @@ int main() {
 
         LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
         std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
-
-		for (int i = 0; i < elements.size(); i++) {
-			double E = E1*pow(rho[i], p) + E0*(1.0 - pow(rho[i], p));
-			std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-            Matrix<double> Ke;
-            PlaneStrainStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, E, 0.3, 1.0);
-            Assembling(K, F, u, Ke, nodetoglobal, nodetoelement, elements[i]);
-		}
+        simp.AssemblingStiffness(K, F, u, nodetoglobal, rho);
         Assembling(F, qfixed, nodetoglobal);
 
         CSR<double> Kmod = CSR<double>(K);	
-        std::vector<double> result = ScalingCG(Kmod, F, 100000, 1.0e-10);
+        std::vector<double> result = ScalingCG(Kmod, F, 100000, 1.0e-10, extrapolation.Predict(Kmod, F));
+        extrapolation.Push(result);
         Disassembling(u, result, nodetoglobal);
 
         //--------------------Get reaction force--------------------
-        RemoveBoundaryConditions(nodetoglobal);
-        KDEGREE = Renumbering(nodetoglobal);
-        std::vector<double> RF = std::vector<double>(KDEGREE, 0.0);
         std::vector<Vector<double> > r = std::vector<Vector<double> >(x.size(), Vector<double>(2));	
-
-        for (int i = 0; i < elements.size(); i++) {
-            double E = E1*pow(rho[i], p) + E0*(1.0 - pow(rho[i], p));
-			std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-            Matrix<double> Ke;
-            PlaneStrainStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, E, 0.3, 1.0);
-            Vector<double> Keue = Ke*ElementVector(u, nodetoelement, elements[i]);
-            Assembling(RF, Keue, nodetoglobal, nodetoelement, elements[i]);
-        }
-
-        Disassembling(r, RF, nodetoglobal);
+        simp.GetReactionForce(r, u, rho);
 
         //--------------------Get compliance and sensitivities--------------------
-        double f = scale0*std::inner_product(u.begin(), u.end(), r.begin(), 0.0);
-		std::vector<double> dfdrho = std::vector<double>(s.size(), 0.0);
-      
-        for(int i = 0; i < elements.size(); i++){
-            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-            Matrix<double> Ke;
-            PlaneStrainStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, 1.0, 0.3, 1.0);
-			Vector<double> ue = ElementVector(u, nodetoelement, elements[i]);
-            dfdrho[i] = -scale0*p*(- E0 + E1)*pow(rho[i], p - 1.0)*(ue*(Ke*ue));
+		std::vector<double> dfdrho;
+        double f = scale0*simp.GetComplianceSensitivities(u, rho, dfdrho);
+        for(auto& dfdrhoi : dfdrho){
+            dfdrhoi *= scale0;
         }
 
 
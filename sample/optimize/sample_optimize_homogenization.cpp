@@ -17,6 +17,8 @@
 #include "../../src/PrePost/Import/ImportFromCSV.h"
 #include "../../src/PrePost/Mesher/SquareMesh.h"
 #include "../../src/Optimize/Filter/DensityFilter.h"
+#include "../../src/Optimize/Material/HomogenizedMaterial.h"
+#include "../../src/Optimize/Material/TabulatedMaterial.h"
 
 
 using namespace PANSFEM2;
@@ -41,85 +43,23 @@ int main() {
     //*****************************************************
     //  Numerical Material Experiment
     //*****************************************************
-    std::vector<std::vector<Matrix<double> > > CH = std::vector<std::vector<Matrix<double> > > (as.size(), std::vector<Matrix<double> >(bs.size())); 
-    for(int i = 0; i < as.size(); i++) {
-        for(int j = 0; j < bs.size(); j++) {
-            //----------Make model of an unit cell----------
-            SquareAnnulusMesh<double> mesh = SquareAnnulusMesh<double>(1.0, 1.0, 1.0 - as[i], 1.0 - bs[j], 10, 10, 10);
-            std::vector<Vector<double> > x = mesh.GenerateNodes();
-            std::vector<std::vector<int> > elements = mesh.GenerateElements();
-            std::vector<std::pair<int, int> > ufixed;
-            ImportPeriodicFromCSV(ufixed, model_path + "Periodic.csv");
-
-            std::vector<Vector<double> > chi0 = std::vector<Vector<double> >(x.size(), Vector<double>(2));
-            std::vector<Vector<double> > chi1 = std::vector<Vector<double> >(x.size(), Vector<double>(2));
-            std::vector<Vector<double> > chi2 = std::vector<Vector<double> >(x.size(), Vector<double>(2));
-            std::vector<std::vector<int> > nodetoglobal = std::vector<std::vector<int> >(x.size(), std::vector<int>(2, 0));
-            int KDEGREE = SetPeriodic(nodetoglobal, ufixed);
-
-
-            //----------Get characteristics displacement----------
-            LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
-            std::vector<double> F0 = std::vector<double>(KDEGREE, 0.0);
-            std::vector<double> F1 = std::vector<double>(KDEGREE, 0.0);
-            std::vector<double> F2 = std::vector<double>(KDEGREE, 0.0);
-            
-            for (auto element : elements) {
-                std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-                Matrix<double> Ke;
-                PlaneStrainStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, element, { 0, 1 }, x, E0, Poisson0, 1.0);
-                Assembling(K, Ke, nodetoglobal, nodetoelement, element);
-                Assembling(F0, chi0, Ke, nodetoglobal, nodetoelement, element);
-                Assembling(F1, chi1, Ke, nodetoglobal, nodetoelement, element);
-                Assembling(F2, chi2, Ke, nodetoglobal, nodetoelement, element);
-
-                Matrix<double> Fes;
-                HomogenizePlaneStrainBodyForce<double, ShapeFunction4Square, Gauss4Square>(Fes, nodetoelement, element, { 0, 1 }, x, E0, Poisson0, 1.0);
-                Vector<double> Fe0 = Fes.Block(0, 0, Ke.ROW(), 1);
-                Assembling(F0, Fe0, nodetoglobal, nodetoelement, element);
-                Vector<double> Fe1 = Fes.Block(0, 1, Ke.ROW(), 1);
-                Assembling(F1, Fe1, nodetoglobal, nodetoelement, element);
-                Vector<double> Fe2 = Fes.Block(0, 2, Ke.ROW(), 1);
-                Assembling(F2, Fe2, nodetoglobal, nodetoelement, element);
-            }
-
-            for (auto element : elements) {
-                std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-                Matrix<double> Ke;
-                WeakSpring<double>(Ke, nodetoelement, element, { 0, 1 }, x, 1.0e-9);
-                Assembling(K, Ke, nodetoglobal, nodetoelement, element);
-            }
-
-            CSR<double> Kmod = CSR<double>(K);
-            std::vector<double> result0 = ScalingCG(Kmod, F0, 100000, 1.0e-10);
-            Disassembling(chi0, result0, nodetoglobal);
-            std::vector<double> result1 = ScalingCG(Kmod, F1, 100000, 1.0e-10);
-            Disassembling(chi1, result1, nodetoglobal);
-            std::vector<double> result2 = ScalingCG(Kmod, F2, 100000, 1.0e-10);
-            Disassembling(chi2, result2, nodetoglobal);
-
-
-            //----------Get homogenized value----------
-            CH[i][j] = Matrix<double>(3, 3);
-            for (auto element : elements) {
-                CH[i][j] += HomogenizePlaneStrainConstitutive<double, ShapeFunction4Square, Gauss4Square>(x, element, chi0, chi1, chi2, E0, Poisson0, 1.0);
-            }
-            CH[i][j] /= Volume0;
-
-            //----------Export result of Numerical Material Experiment----------
-            /*std::ofstream fout(model_path + "result_microscopic_a" + std::to_string(i) + "b_" + std::to_string(j) + ".vtk");
-            MakeHeadderToVTK(fout);
-            AddPointsToVTK(x, fout);
-            AddElementToVTK(elements, fout);
-            AddElementTypes(std::vector<int>(elements.size(), 9), fout);
-            AddPointVectors(chi0, "chi0", fout, true);
-            AddPointVectors(chi1, "chi1", fout, false);
-            AddPointVectors(chi2, "chi2", fout, false);
-            fout.close();*/
-        }
+    //  Table of CH is loaded from binary cache made with the same grid and material, or made once with unit cells sharing one mesh topology
+    std::vector<double> parameters = { E0, Poisson0, Volume0 };
+    TabulatedMaterial<double> table;
+    if(!table.ImportFromBinary(model_path + "CH.bin", as, bs, parameters)) {
+        SquareAnnulusMesh<double> mesh0 = SquareAnnulusMesh<double>(1.0, 1.0, 0.5, 0.5, 10, 10, 10);
+        std::vector<std::pair<int, int> > periodic;
+        ImportPeriodicFromCSV(periodic, model_path + "Periodic.csv");
+        HomogenizedMaterial<double, ShapeFunction4Square, Gauss4Square> material = HomogenizedMaterial<double, ShapeFunction4Square, Gauss4Square>(mesh0.GenerateNodes().size(), mesh0.GenerateElements(), periodic, E0, Poisson0, 1.0, Volume0);
+        std::vector<std::vector<Matrix<double> > > CH = material.GetConstitutives(as, bs, [](double _a, double _b){
+            SquareAnnulusMesh<double> mesh = SquareAnnulusMesh<double>(1.0, 1.0, 1.0 - _a, 1.0 - _b, 10, 10, 10);
+            return mesh.GenerateNodes();
+        });
+        table = TabulatedMaterial<double>(as, bs, CH);
+        table.ExportToBinary(model_path + "CH.bin", parameters);
     }
 
-    
+
     //*****************************************************
     //  Define Macroscopic problem
     //*****************************************************
@@ -178,6 +118,14 @@ int main() {
         //  Get compliance value and sensitivities
         //*************************************************
 
+        //--------------------Get constitutives and derivatives of all elements--------------------
+        std::vector<double> thetas = std::vector<double>(elements.size());
+        for(int i = 0; i < elements.size(); i++) {
+            thetas[i] = 0.5*M_PI*((t[i] - 0.001)/0.998 - 0.5);
+        }
+        std::vector<Matrix<double> > CH, dCHda, dCHdb, dCHdtheta;
+        table.GetConstitutives(a, b, thetas, CH, dCHda, dCHdb, dCHdtheta);
+
         //--------------------Get displacement--------------------
 		std::vector<Vector<double> > u = std::vector<Vector<double> >(x.size(), Vector<double>(2));
         std::vector<std::vector<int> > nodetoglobal = std::vector<std::vector<int> >(x.size(), std::vector<int>(2, 0));
@@ -189,23 +137,9 @@ int main() {
         std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
 
 		for (int i = 0; i < elements.size(); i++) {
-			Matrix<double> CHi = Matrix<double>(3, 3);  
-            std::vector<double> N = LagrangeInterpolation(as, a[i]);
-            std::vector<double> M = LagrangeInterpolation(bs, b[i]);
-            for(int n = 0; n < as.size(); n++) {
-                for(int m = 0; m < bs.size(); m++) {
-                    CHi += N[n]*M[m]*CH[n][m];
-                } 
-            }
-            double theta = 0.5*M_PI*((t[i] - 0.001)/0.998 - 0.5);
-            Matrix<double> R = Matrix<double>(3, 3);
-            R(0, 0) = cos(theta)*cos(theta);        R(0, 1) = sin(theta)*sin(theta);        R(0, 2) = cos(theta)*sin(theta);
-            R(1, 0) = sin(theta)*sin(theta);        R(1, 1) = cos(theta)*cos(theta);        R(1, 2) = -sin(theta)*cos(theta);
-            R(2, 0) = -2.0*cos(theta)*sin(theta);   R(2, 1) = 2.0*sin(theta)*cos(theta);    R(2, 2) = cos(theta)*cos(theta) - sin(theta)*sin(theta);
-            CHi = R.Transpose()*CHi*R;
 			std::vector<std::vector<std::pair<int, int> > > nodetoelement;
             Matrix<double> Ke;
-            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, CHi, 1.0);
+            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, CH[i], 1.0);
             Assembling(K, F, u, Ke, nodetoglobal, nodetoelement, elements[i]);
 		}
         Assembling(F, qfixed, nodetoglobal);
@@ -221,23 +155,9 @@ int main() {
         std::vector<Vector<double> > r = std::vector<Vector<double> >(x.size(), Vector<double>(2));	
 
         for (int i = 0; i < elements.size(); i++) {
-            Matrix<double> CHi = Matrix<double>(3, 3);  
-            std::vector<double> N = LagrangeInterpolation(as, a[i]);
-            std::vector<double> M = LagrangeInterpolation(bs, b[i]);
-            for(int n = 0; n < as.size(); n++) {
-                for(int m = 0; m < bs.size(); m++) {
-                    CHi += N[n]*M[m]*CH[n][m];
-                } 
-            }
-            double theta = 0.5*M_PI*((t[i] - 0.001)/0.998 - 0.5);
-            Matrix<double> R = Matrix<double>(3, 3);
-            R(0, 0) = cos(theta)*cos(theta);        R(0, 1) = sin(theta)*sin(theta);        R(0, 2) = cos(theta)*sin(theta);
-            R(1, 0) = sin(theta)*sin(theta);        R(1, 1) = cos(theta)*cos(theta);        R(1, 2) = -sin(theta)*cos(theta);
-            R(2, 0) = -2.0*cos(theta)*sin(theta);   R(2, 1) = 2.0*sin(theta)*cos(theta);    R(2, 2) = cos(theta)*cos(theta) - sin(theta)*sin(theta);
-            CHi = R.Transpose()*CHi*R;
 			std::vector<std::vector<std::pair<int, int> > > nodetoelement;
             Matrix<double> Ke;
-            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, CHi, 1.0);
+            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, CH[i], 1.0);
             Vector<double> Keue = Ke*ElementVector(u, nodetoelement, elements[i]);
             Assembling(RF, Keue, nodetoglobal, nodetoelement, elements[i]);
         }
@@ -250,41 +170,15 @@ int main() {
         std::vector<double> dfdb = std::vector<double>(b.size(), 0.0);
         std::vector<double> dfdt = std::vector<double>(t.size(), 0.0);
         for(int i = 0; i < elements.size(); i++){
-            Matrix<double> dCHida = Matrix<double>(3, 3);
-            Matrix<double> dCHidb = Matrix<double>(3, 3);
-            Matrix<double> dCHidt = Matrix<double>(3, 3);
-            std::vector<double> N = LagrangeInterpolation(as, a[i]);
-            std::vector<double> dNdr = LagrangeInterpolationDerivative(as, a[i]);
-            std::vector<double> M = LagrangeInterpolation(bs, b[i]);
-            std::vector<double> dMdr = LagrangeInterpolationDerivative(bs, b[i]);
-            for(int n = 0; n < as.size(); n++) {
-                for(int m = 0; m < bs.size(); m++) {
-                    dCHida += dNdr[n]*M[m]*CH[n][m];
-                    dCHidb += N[n]*dMdr[m]*CH[n][m];
-                    dCHidt += N[n]*M[m]*CH[n][m];
-                } 
-            }
-            double theta = 0.5*M_PI*((t[i] - 0.001)/0.998 - 0.5);
-            Matrix<double> R = Matrix<double>(3, 3);
-            R(0, 0) = cos(theta)*cos(theta);        R(0, 1) = sin(theta)*sin(theta);        R(0, 2) = cos(theta)*sin(theta);
-            R(1, 0) = sin(theta)*sin(theta);        R(1, 1) = cos(theta)*cos(theta);        R(1, 2) = -sin(theta)*cos(theta);
-            R(2, 0) = -2.0*cos(theta)*sin(theta);   R(2, 1) = 2.0*sin(theta)*cos(theta);    R(2, 2) = cos(theta)*cos(theta) - sin(theta)*sin(theta);
-            Matrix<double> dR = Matrix<double>(3, 3);
-            dR(0, 0) = -sin(2.0*theta);     dR(0, 1) = sin(2.0*theta);      dR(0, 2) = cos(2.0*theta);
-            dR(1, 0) = sin(2.0*theta);      dR(1, 1) = -sin(2.0*theta);     dR(1, 2) = -cos(2.0*theta);
-            dR(2, 0) = -2.0*cos(2.0*theta); dR(2, 1) = 2.0*cos(2.0*theta);  dR(2, 2) = -2.0*sin(2.0*theta);
-            dCHida = R.Transpose()*dCHida*R;
-            dCHidb = R.Transpose()*dCHidb*R;
-            dCHidt = 0.5*M_PI/0.998*(dR.Transpose()*dCHidt*R + R.Transpose()*dCHidt*dR);
             std::vector<std::vector<std::pair<int, int> > > nodetoelement;
             Matrix<double> dKeda, dKedb, dKedt;
-            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(dKeda, nodetoelement, elements[i], { 0, 1 }, x, dCHida, 1.0);
-            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(dKedb, nodetoelement, elements[i], { 0, 1 }, x, dCHidb, 1.0);
-            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(dKedt, nodetoelement, elements[i], { 0, 1 }, x, dCHidt, 1.0);
+            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(dKeda, nodetoelement, elements[i], { 0, 1 }, x, dCHda[i], 1.0);
+            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(dKedb, nodetoelement, elements[i], { 0, 1 }, x, dCHdb[i], 1.0);
+            PlaneStiffness<double, ShapeFunction8Square, Gauss9Square>(dKedt, nodetoelement, elements[i], { 0, 1 }, x, dCHdtheta[i], 1.0);
 			Vector<double> ue = ElementVector(u, nodetoelement, elements[i]);
             dfda[i] = -ue*(dKeda*ue);
             dfdb[i] = -ue*(dKedb*ue);
-            dfdt[i] = -ue*(dKedt*ue);
+            dfdt[i] = -ue*(dKedt*ue)*0.5*M_PI/0.998;
         }
          
         //*************************************************
@@ -13,8 +13,9 @@
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
-#include "../../src/LinearAlgebra/Solvers/CG.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
+#include "../../src/Optimize/Material/SIMP.h"
+#include "../../src/Optimize/Solver/LevelSet.h"
 
 
 using namespace PANSFEM2;
@@ -69,6 +70,17 @@ int main() {
     std::vector<double> str = std::vector<double>(elements.size(), 1.0);                    //  χ(φ)
     double volInit = std::accumulate(str.begin(), str.end(), 0.0)/(double)elements.size();
     std::vector<double> objective = std::vector<double>(tmax);
+
+
+    //----------要素剛性行列とレベルセット更新の演算子を一度だけ作成----------
+    //  Emin + χ*(E0 - Emin)の剛性と，トポロジカルデリバティブの係数1.0e-4 + χ*(1.0 - 1.0e-4)をSIMP(p = 1)で表す
+    SIMP<double> stiffness = SIMP<double>(x, elements, [&](Matrix<double>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        PlaneStressStiffness<double, ShapeFunction4Square, Gauss4Square>(_Ke, _nodetoelement, _element, { 0, 1 }, x, 1.0, nu, 1.0);
+    }, Emin, E0, 1.0);
+    SIMP<double> topologicalderivative = SIMP<double>(x, elements, [&](Matrix<double>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        PlaneStressStiffness<double, ShapeFunction4Square, Gauss4Square>(_Ke, _nodetoelement, _element, { 0, 1 }, x, (A1 + 2.0*A2)*(1.0 - pow(c, 2.0)), c, 1.0);
+    }, 1.0e-4, 1.0, 1.0);
+    LevelSet<double, ShapeFunction4Square, Gauss4Square> levelset = LevelSet<double, ShapeFunction4Square, Gauss4Square>(x, elements, phifixed, tau*elements.size(), dt);
     
 
     //----------最適化ループ----------
@@ -83,13 +95,7 @@ int main() {
         LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
         std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
 
-		for (int i = 0; i < elements.size(); i++) {
-			std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-            Matrix<double> Ke;
-            PlaneStressStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, Emin + str[i]*(E0 - Emin), nu, 1.0);
-            Assembling(K, F, u, Ke, nodetoglobal, nodetoelement, elements[i]);
-		}
-
+        stiffness.AssemblingStiffness(K, F, u, nodetoglobal, str);
         Assembling(F, qfixed, nodetoglobal);
 
         CSR<double> Kmod = CSR<double>(K);	
@@ -110,16 +116,13 @@ int main() {
 
 
         //----------トポロジカルデリバティブと体積の計算----------
+        std::vector<double> dfdstr;
+        objective[t] = stiffness.GetComplianceSensitivities(u, str, dfdstr);
+        std::vector<double> energies = topologicalderivative.GetStrainEnergies(u);
         std::vector<Vector<double> > TD = std::vector<Vector<double> >(elements.size(), Vector<double>(1));
-        std::vector<int> NC = std::vector<int>(x.size(), 0);
+#pragma omp parallel for
         for (int i = 0; i < elements.size(); i++) {
-			std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-            Matrix<double> Ke;
-            PlaneStressStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, Emin + str[i]*(E0 - Emin), nu, 1.0);
-            Vector<double> ue = ElementVector(u, nodetoelement, elements[i]);
-            objective[t] += ue*(Ke*ue);
-            PlaneStressStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, elements[i], { 0, 1 }, x, (A1 + 2.0*A2)*(1.0 - pow(c, 2.0)), c, 1.0);
-            TD[i](0) = (1.0e-4 + str[i]*(1.0 - 1.0e-4))*ue*(Ke*ue);
+            TD[i](0) = topologicalderivative.E(str[i])*energies[i];
         }
         std::vector<Vector<double> > TDN = InterpolateNodalFromElemental<double, Vector>(x.size(), Vector<double>(1), TD, elements);
         
@@ -150,36 +153,7 @@ int main() {
         }
         C = elements.size()/C;
 
-        std::vector<std::vector<int> > nodetoglobal2 = std::vector<std::vector<int> >(x.size(), std::vector<int>(1, 0));
-        SetDirichlet(phi, nodetoglobal2, phifixed);
-        int TDEGREE = Renumbering(nodetoglobal2);
-
-        LILCSR<double> T = LILCSR<double>(TDEGREE, TDEGREE);
-        std::vector<double> Y = std::vector<double>(TDEGREE, 0.0);
-
-		for (int i = 0; i < elements.size(); i++) {
-            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-			Matrix<double> Me, Ke;
-            Vector<double> Fe;
-            ReactionDiffusionConsistentMass<double, ShapeFunction4Square, Gauss4Square>(Me, nodetoelement, elements[i], { 0 }, x);
-            ReactionDiffusionStiffness<double, ShapeFunction4Square, Gauss4Square>(Ke, nodetoelement, elements[i], { 0 }, x, tau*elements.size());
-            ReactionDiffusionReaction<double, ShapeFunction4Square, Gauss4Square>(Fe, nodetoelement, elements[i], { 0 }, x, TDN, [&](double _u, Vector<double> _dudX) {
-                return C*(_u - lambda);
-            });
-			Vector<double> phie = ElementVector(phi, nodetoelement, elements[i]);
-			Matrix<double> Te = Me/dt + Ke;
-			Vector<double> Ye = Me/dt*phie + Fe; 
-			Assembling(T, Y, phi, Te, nodetoglobal2, nodetoelement, elements[i]);
-            Assembling(Y, Ye, nodetoglobal2, nodetoelement, elements[i]);
-		}
-
-        CSR<double> Tmod = CSR<double>(T);	
-        std::vector<double> result2 = ScalingCG(Tmod, Y, 100000, 1.0e-10);
-        Disassembling(phi, result2, nodetoglobal2);
-
-        for(int i = 0; i < x.size(); i++) {
-            phi[i](0) = std::max(std::min(1.0, phi[i](0)), -1.0);
-        }
+        levelset.UpdateLevelSet(phi, TDN, C, lambda);
 
         std::vector<Vector<double> > phie = InterpolateElementalFromNodal<double, Vector>(Vector<double>(1), phi, elements);
         for(int i = 0; i < elements.size(); i++) {
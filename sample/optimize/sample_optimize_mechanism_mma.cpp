@@ -0,0 +1,210 @@
+#include <iostream>
+#include <vector>
+
+
+#include "../../src/LinearAlgebra/Models/Vector.h"
+#include "../../src/FEM/Equation/PlaneStrain.h"
+#include "../../src/FEM/Controller/ShapeFunction.h"
+#include "../../src/FEM/Controller/GaussIntegration.h"
+#include "../../src/FEM/Controller/BoundaryCondition.h"
+#include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/LinearAlgebra/Solvers/CG.h"
+#include "../../src/FEM/Controller/SolutionExtrapolation.h"
+#include "../../src/PrePost/Export/ExportToVTK.h"
+#include "../../src/Optimize/Solver/MMA.h"
+#include "../../src/Optimize/Filter/HeavisideFilter.h"
+#include "../../src/Optimize/Filter/NeighborSearch.h"
+#include "../../src/PrePost/Mesher/SquareMesh.h"
+#include "../../src/FEM/Equation/General.h"
+#include "../../src/Optimize/Material/SIMP.h"
+
+
+using namespace PANSFEM2;
+
+
+//  Force inverter : pushing input port (0, 0) to +x moves output port (60, 0) to -x.
+//  Upper half of the mechanism is designed with symmetry at y = 0.
+int main() {
+    //----------Generate design region----------
+	SquareMesh<double> mesh = SquareMesh<double>(60.0, 30.0, 60, 30);
+    std::vector<Vector<double> > x = mesh.GenerateNodes();
+    std::vector<std::vector<int> > elements = mesh.GenerateElements();
+    std::vector<std::pair<std::pair<int, int>, double> > ufixed = mesh.GenerateFixedlist({ 0, 1 }, [](Vector<double> _x){
+        if(abs(_x(0)) < 1.0e-5 && _x(1) > 27.0 - 1.0e-5) {
+            return true;
+        }
+        return false;
+    });
+    std::vector<std::pair<std::pair<int, int>, double> > usymmetry = mesh.GenerateFixedlist({ 1 }, [](Vector<double> _x){
+        if(abs(_x(1)) < 1.0e-5) {
+            return true;
+        }
+        return false;
+    });
+    ufixed.insert(ufixed.end(), usymmetry.begin(), usymmetry.end());
+
+    //----------Get input and output ports----------
+    int nodein = 0, nodeout = 0;
+    for(int i = 0; i < x.size(); i++){
+        if(abs(x[i](0)) < 1.0e-5 && abs(x[i](1)) < 1.0e-5) {
+            nodein = i;
+        }
+        if(abs(x[i](0) - 60.0) < 1.0e-5 && abs(x[i](1)) < 1.0e-5) {
+            nodeout = i;
+        }
+    }
+    double fin = 1.0;           //  Input force
+    double kin = 0.1;           //  Stiffness of input spring
+    double kout = 0.1;          //  Stiffness of output spring
+
+	//----------Get cg of element----------
+    std::vector<Vector<double> > cg = std::vector<Vector<double> >(elements.size());
+    for(int i = 0; i < elements.size(); i++){
+        cg[i] = CenterOfGravity(x, elements[i]);
+    }
+
+    //----------Get filter matrix from neighbor elements----------
+    double R = 1.5;
+    NeighborSearch<double> neighborsearch = NeighborSearch<double>(cg, R);
+    CSR<double> H = FilterMatrix(neighborsearch, R);
+
+    //----------Initialize Heaviside filter class----------
+    HeavisideFilter<double> filter = HeavisideFilter<double>(H);
+
+	//----------Initialize design variables----------
+	std::vector<double> s = std::vector<double>(elements.size(), 0.3);
+
+	//----------Define design parameters----------
+	double E0 = 1.0e-9;
+	double E1 = 1.0;
+	double Poisson = 0.3;
+	double p = 3.0;
+
+	double weightlimit = 0.3;
+	double scale0 = 10.0;
+	double scale1 = 1.0;
+
+    double beta = 0.5;
+
+    //----------Make reference stiffness matrices----------
+    SIMP<double> simp = SIMP<double>(x, elements, [&](Matrix<double>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        PlaneStrainStiffness<double, ShapeFunction4Square, Gauss4Square>(_Ke, _nodetoelement, _element, { 0, 1 }, x, 1.0, Poisson, 1.0);
+    }, E0, E1, p);
+
+    MMA<double> optimizer = MMA<double>(s.size(), 1, 1.0,
+		std::vector<double>(1, 0.0),
+		std::vector<double>(1, 10000.0),
+		std::vector<double>(1, 0.0),
+		std::vector<double>(s.size(), 0.01), std::vector<double>(s.size(), 1.0));
+	optimizer.SetParameters(1.0e-5, 0.1, 0.2, 0.5, 0.7, 1.2, 1.0e-6);
+
+    SolutionExtrapolation<double> extrapolation = SolutionExtrapolation<double>(ExtrapolationMethod::POD, 4);           //Initial guess of CG for displacements
+    SolutionExtrapolation<double> extrapolationadjoint = SolutionExtrapolation<double>(ExtrapolationMethod::POD, 4);    //Initial guess of CG for adjoint variables
+
+	//----------Optimize loop----------
+	for(int k = 0; k < 500; k++){
+		std::cout << "\nk = " << k << "\t";
+        if(k%40 == 0){
+            beta*=2.0;
+            filter.UpdateBeta(beta);
+        }
+
+        //*************************************************
+        //  Get filterd design variables
+        //*************************************************
+        std::vector<double> rho = filter.GetFilteredVariables(s);
+
+
+        //*************************************************
+        //  Get weight value and sensitivities
+        //*************************************************
+        double g = 0.0;														//Function values of weight
+		std::vector<double> dgdrho = std::vector<double>(s.size(), 0.0);    //Sensitivities of weight
+        for(int i = 0; i < elements.size(); i++){
+            g += scale1*rho[i]/(weightlimit*elements.size());
+            dgdrho[i] = scale1/(weightlimit*elements.size());
+        }
+        g -= 1.0*scale1;
+
+
+        //*************************************************
+        //  Get output displacement and sensitivities
+        //*************************************************
+
+        //--------------------Get displacement--------------------
+		std::vector<Vector<double> > u = std::vector<Vector<double> >(x.size(), Vector<double>(2));
+        std::vector<std::vector<int> > nodetoglobal = std::vector<std::vector<int> >(x.size(), std::vector<int>(2, 0));
+
+        SetDirichlet(u, nodetoglobal, ufixed);
+        int KDEGREE = Renumbering(nodetoglobal);
+        int globalin = nodetoglobal[nodein][0], globalout = nodetoglobal[nodeout][0];
+
+        LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
+        std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
+        simp.AssemblingStiffness(K, F, u, nodetoglobal, rho);
+        K.set(globalin, globalin, K.get(globalin, globalin) + kin);
+        K.set(globalout, globalout, K.get(globalout, globalout) + kout);
+        F[globalin] += fin;
+
+        CSR<double> Kmod = CSR<double>(K);
+        std::vector<double> D = GetDiagonal(Kmod);                          //Preconditioner shared by forward and adjoint solve
+        std::vector<double> result = ScalingCG(Kmod, D, F, 100000, 1.0e-10, extrapolation.Predict(Kmod, F));
+        extrapolation.Push(result);
+        Disassembling(u, result, nodetoglobal);
+
+        //--------------------Get adjoint variables of K*lambda = df/du----------------------
+        //  K is symmetric, so adjoint equation is solved with the same matrix and preconditioner
+        std::vector<Vector<double> > lambda = std::vector<Vector<double> >(x.size(), Vector<double>(2));
+        std::vector<double> L = std::vector<double>(KDEGREE, 0.0);
+        L[globalout] = 1.0;
+        std::vector<double> resultadjoint = ScalingCG(Kmod, D, L, 100000, 1.0e-10, extrapolationadjoint.Predict(Kmod, L));
+        extrapolationadjoint.Push(resultadjoint);
+        Disassembling(lambda, resultadjoint, nodetoglobal);
+
+        //--------------------Get output displacement and sensitivities--------------------
+		std::vector<double> dfdrho;
+        double f = scale0*u[nodeout](0);
+        simp.GetAdjointSensitivities(u, lambda, rho, dfdrho);
+        for(auto& dfdrhoi : dfdrho){
+            dfdrhoi *= scale0;
+        }
+
+
+        //*************************************************
+        //  Filtering sensitivities
+        //*************************************************
+        std::vector<double> dfds = filter.GetFilteredSensitivitis(s, dfdrho);
+        std::vector<double> dgds = filter.GetFilteredSensitivitis(s, dgdrho);
+
+
+        //*************************************************
+        //  Post Process
+        //*************************************************
+		std::ofstream fout("sample/optimize/result" + std::to_string(k) + ".vtk");
+		MakeHeadderToVTK(fout);
+		AddPointsToVTK(x, fout);
+		AddElementToVTK(elements, fout);
+		AddElementTypes(std::vector<int>(elements.size(), 9), fout);
+		AddPointVectors(u, "u", fout, true);
+        AddPointVectors(lambda, "lambda", fout, false);
+		AddElementScalers(rho, "s", fout, true);
+		fout.close();
+
+
+        //*************************************************
+        //  Update design variables with MMA
+        //*************************************************
+
+		//----------Check convergence----------
+        std::cout << "Objective:\t" << f/scale0 << "\tWeight:\t" << g/scale1 << "\t";
+		if(optimizer.IsConvergence(f)){
+			std::cout << std::endl << "--------------------Optimized--------------------" << std::endl;
+			break;
+		}
+
+		//----------Get updated design variables with MMA----------
+		optimizer.UpdateVariables(s, f, dfds, { g }, { dgds });
+	}
+
+	return 0;
+}
@@ -0,0 +1,171 @@
+#include <iostream>
+#include <vector>
+
+
+#include "../../src/LinearAlgebra/Models/Vector.h"
+#include "../../src/FEM/Equation/PlaneStrain.h"
+#include "../../src/FEM/Controller/ShapeFunction.h"
+#include "../../src/FEM/Controller/GaussIntegration.h"
+#include "../../src/FEM/Controller/BoundaryCondition.h"
+#include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/LinearAlgebra/Solvers/CG.h"
+#include "../../src/PrePost/Export/ExportToVTK.h"
+#include "../../src/Optimize/Solver/MMA.h"
+#include "../../src/Optimize/Filter/HeavisideFilter.h"
+#include "../../src/Optimize/Filter/NeighborSearch.h"
+#include "../../src/PrePost/Mesher/SquareMesh.h"
+#include "../../src/FEM/Equation/General.h"
+#include "../../src/Optimize/Material/SIMP.h"
+#include "../../src/Optimize/Material/MultiLoadCompliance.h"
+
+
+using namespace PANSFEM2;
+
+
+int main() {
+    //----------Generate design region----------
+	SquareMesh<double> mesh = SquareMesh<double>(60.0, 40.0, 60, 40);
+    std::vector<Vector<double> > x = mesh.GenerateNodes();
+    std::vector<std::vector<int> > elements = mesh.GenerateElements();
+    std::vector<std::pair<std::pair<int, int>, double> > ufixed = mesh.GenerateFixedlist({ 0, 1 }, [](Vector<double> _x){
+        if(abs(_x(0)) < 1.0e-5) {
+            return true;
+        }
+        return false;
+    });
+    //  Three load cases at upper, middle and lower points of right edge
+    std::vector<std::vector<std::pair<std::pair<int, int>, double> > > qfixeds;
+    for(double yload : { 0.0, 20.0, 40.0 }){
+        std::vector<std::pair<std::pair<int, int>, double> > qfixed = mesh.GenerateFixedlist({ 1 }, [&](Vector<double> _x){
+            if(abs(_x(0) - 60.0) < 1.0e-5 && abs(_x(1) - yload) < 1.0e-5) {
+                return true;
+            }
+            return false;
+        });
+        for(auto& qfixedi : qfixed) {
+            qfixedi.second = -1.0;
+        }
+        qfixeds.push_back(qfixed);
+    }
+
+	//----------Get cg of element----------
+    std::vector<Vector<double> > cg = std::vector<Vector<double> >(elements.size());
+    for(int i = 0; i < elements.size(); i++){
+        cg[i] = CenterOfGravity(x, elements[i]);
+    }
+
+    //----------Get filter matrix from neighbor elements----------
+    double R = 1.5;
+    NeighborSearch<double> neighborsearch = NeighborSearch<double>(cg, R);
+    CSR<double> H = FilterMatrix(neighborsearch, R);
+
+    //----------Initialize Heaviside filter class----------
+    HeavisideFilter<double> filter = HeavisideFilter<double>(H);
+
+	//----------Initialize design variables----------
+	std::vector<double> s = std::vector<double>(elements.size(), 0.5);
+
+	//----------Define design parameters----------
+	double E0 = 0.0001;
+	double E1 = 210000.0;
+	double Poisson = 0.3;
+	double p = 3.0;
+
+	double weightlimit = 0.5;
+	double scale0 = 1.0e5;
+	double scale1 = 1.0;
+
+    double beta = 0.5;
+
+    //----------Make reference stiffness matrices----------
+    SIMP<double> simp = SIMP<double>(x, elements, [&](Matrix<double>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        PlaneStrainStiffness<double, ShapeFunction4Square, Gauss4Square>(_Ke, _nodetoelement, _element, { 0, 1 }, x, 1.0, Poisson, 1.0);
+    }, E0, E1, p);
+
+    //----------Initialize multi-load compliance sharing K among load cases----------
+    MultiLoadCompliance<double> compliance = MultiLoadCompliance<double>(simp, x.size(), 2, ufixed, qfixeds);
+
+    MMA<double> optimizer = MMA<double>(s.size(), 1, 1.0,
+		std::vector<double>(1, 0.0),
+		std::vector<double>(1, 10000.0),
+		std::vector<double>(1, 0.0), 
+		std::vector<double>(s.size(), 0.01), std::vector<double>(s.size(), 1.0));
+	optimizer.SetParameters(1.0e-5, 0.1, 0.2, 0.5, 0.7, 1.2, 1.0e-6);
+			
+	//----------Optimize loop----------
+	for(int k = 0; k < 500; k++){
+		std::cout << "\nk = " << k << "\t";
+        if(k%40 == 0){
+            beta*=2.0;
+            filter.UpdateBeta(beta);
+        }
+
+        //*************************************************
+        //  Get filterd design variables
+        //*************************************************
+        std::vector<double> rho = filter.GetFilteredVariables(s);
+
+
+        //*************************************************
+        //  Get weight value and sensitivities
+        //*************************************************
+        double g = 0.0;														//Function values of weight
+		std::vector<double> dgdrho = std::vector<double>(s.size(), 0.0);    //Sensitivities of weight
+        for(int i = 0; i < elements.size(); i++){
+            g += scale1*rho[i]/(weightlimit*elements.size());
+            dgdrho[i] = scale1/(weightlimit*elements.size()); 
+        }
+        g -= 1.0*scale1;
+
+        
+        //*************************************************
+        //  Get compliance value and sensitivities of all load cases
+        //*************************************************
+        
+        //--------------------Get sum of compliances and sensitivities--------------------
+		std::vector<double> dfdrho;
+        double f = scale0*compliance.GetComplianceSensitivities(rho, dfdrho);
+        for(auto& dfdrhoi : dfdrho){
+            dfdrhoi *= scale0;
+        }
+
+
+        //*************************************************
+        //  Filtering sensitivities
+        //*************************************************
+        std::vector<double> dfds = filter.GetFilteredSensitivitis(s, dfdrho);
+        std::vector<double> dgds = filter.GetFilteredSensitivitis(s, dgdrho);
+		
+        
+        //*************************************************
+        //  Post Process
+        //*************************************************
+		std::ofstream fout("sample/optimize/result" + std::to_string(k) + ".vtk");
+		MakeHeadderToVTK(fout);
+		AddPointsToVTK(x, fout);
+		AddElementToVTK(elements, fout);
+		AddElementTypes(std::vector<int>(elements.size(), 9), fout);
+        for(int l = 0; l < compliance.LOADS(); l++){
+            AddPointVectors(compliance.u[l], "u" + std::to_string(l), fout, l == 0);
+        }
+		AddElementScalers(rho, "s", fout, true);
+		fout.close();
+       
+
+        //*************************************************
+        //  Update design variables with MMA
+        //*************************************************
+
+		//----------Check convergence----------
+        std::cout << "Objective:\t" << f/scale0 << "\tWeight:\t" << g/scale1 << "\t";
+		if(optimizer.IsConvergence(f)){
+			std::cout << std::endl << "--------------------Optimized--------------------" << std::endl;
+			break;
+		}
+		
+		//----------Get updated design variables with MMA----------
+		optimizer.UpdateVariables(s, f, dfds, { g }, { dgds });	
+	}
+	
+	return 0;
+}
\ No newline at end of file
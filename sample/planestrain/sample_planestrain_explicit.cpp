@@ -0,0 +1,96 @@
+#include <iostream>
+#include <vector>
+
+
+#include "../../src/LinearAlgebra/Models/Vector.h"
+#include "../../src/PrePost/Mesher/SquareMesh.h"
+#include "../../src/FEM/Equation/PlaneStrain.h"
+#include "../../src/FEM/Controller/ShapeFunction.h"
+#include "../../src/FEM/Controller/GaussIntegration.h"
+#include "../../src/FEM/Controller/BoundaryCondition.h"
+#include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/FEM/Controller/TimeIntegration.h"
+#include "../../src/PrePost/Export/ExportToVTK.h"
+
+
+using namespace PANSFEM2;
+
+
+int main() {
+	//********************Set parameters********************
+	double E = 1000.0;
+	double V = 0.3;
+	double rho = 1.0;
+	double t = 1.0;
+	double dt = 0.002;		//	Must be smaller than element size/wave speed
+	int tmax = 5000;
+
+
+	//********************Set model datas********************
+	SquareMesh<double> mesher = SquareMesh<double>(10.0, 1.0, 40, 4);
+	std::vector<Vector<double> > x = mesher.GenerateNodes();
+	std::vector<std::vector<int> > elements = mesher.GenerateElements();
+	std::vector<std::pair<std::pair<int, int>, double> > ufixed = mesher.GenerateFixedlist({ 0, 1 }, [](Vector<double> _x) {
+		if(fabs(_x(0) - 0.0) < 1.0e-5) {
+			return true;
+		}
+		return false;
+	});
+	std::vector<std::pair<std::pair<int, int>, double> > qfixed = mesher.GenerateFixedlist({ 1 }, [](Vector<double> _x) {
+		if(fabs(_x(0) - 10.0) < 1.0e-5) {
+			return true;
+		}
+		return false;
+	});
+	for(auto& qfixedi : qfixed) {
+		qfixedi.second = -0.1;
+	}
+
+	std::vector<Vector<double> > u = std::vector<Vector<double> >(x.size(), Vector<double>(2));		//	Node displacement vector array
+	std::vector<Vector<double> > v = std::vector<Vector<double> >(x.size(), Vector<double>(2));		//	Node velocity vector array
+	std::vector<std::vector<int> > nodetoglobal = std::vector<std::vector<int> >(x.size(), std::vector<int>(2, 0));
+	SetDirichlet(u, nodetoglobal, ufixed);
+	int KDEGREE = Renumbering(nodetoglobal);
+
+
+	//********************Make lumped mass********************
+	ExplicitIntegrator<double> integrator = ExplicitIntegrator<double>(nodetoglobal, dt);
+	for(auto element : elements) {
+		std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+		Matrix<double> Me;
+		PlaneStrainMass<double, ShapeFunction4Square, Gauss4Square>(Me, nodetoelement, element, { 0, 1 }, x, rho, t);
+		integrator.Assembling(Me, nodetoelement, element);
+	}
+
+
+	//********************Time step loop with central difference********************
+	for(int step = 0; step <= tmax; step++) {
+		//----------Get R = F - Fint element by element----------
+		std::vector<double> R = std::vector<double>(KDEGREE, 0.0);
+		AssemblingParallel(R, nodetoglobal, elements, [&](Vector<double>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, int _i) {
+			PlaneStrainInternalForce<double, ShapeFunction4Square, Gauss4Square>(_Fe, _nodetoelement, elements[_i], { 0, 1 }, x, u, E, V, t);
+			_Fe *= -1.0;
+		});
+		Assembling(R, qfixed, nodetoglobal);
+
+		if(step == 0) {
+			integrator.Initialize(u, v, R);
+		}
+
+		//----------Export result----------
+		if(step%500 == 0) {
+			std::cout << "step = " << step << "\tu_tip = " << u[x.size() - 1](1) << std::endl;
+			std::ofstream fout("sample/planestrain/result_explicit" + std::to_string(step/500) + ".vtk");
+			MakeHeadderToVTK(fout);
+			AddPointsToVTK(x, fout);
+			AddElementToVTK(elements, fout);
+			AddElementTypes(std::vector<int>(elements.size(), 9), fout);
+			AddPointVectors(u, "u", fout, true);
+			fout.close();
+		}
+
+		integrator.CentralDifference(u, R);
+	}
+
+	return 0;
+}
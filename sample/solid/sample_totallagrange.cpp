@@ -9,6 +9,7 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
+#include "../../src/FEM/Controller/LoadControl.h"
 #include "../../src/LinearAlgebra/Solvers/CG.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 
@@ -41,45 +42,47 @@ int main() {
 	AddPointVectors(u, "u", fout, true);
 	fout.close();
 
-	for (int finc = 1, fincmax = 100; finc <= fincmax; finc++) {
-		std::cout << "finc = " << finc << "\t";
+	std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
+	Assembling(F, qfixed0, nodetoglobal);
 
-		for (int k = 0; k < 100; k++) {
-			LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
-			std::vector<double> R = std::vector<double>(KDEGREE, 0.0);
-
-			for (auto element : elements) {
-                std::vector<std::vector<std::pair<int, int> > > nodetoelement;
-				Matrix<double> Ke;
-				Vector<double> Qe;
-				SolidTotalLagrange<double, ShapeFunction8Cubic, Gauss8Cubic >(Ke, Qe, nodetoelement, element, { 0, 1, 2, }, x, u, 1000.0, 0.3);
-				Assembling(K, R, u, Ke, Qe, nodetoglobal, nodetoelement, element);
-			}
-
-			double normF = 0.0;
-            std::vector<std::pair<std::pair<int, int>, double> > qfixed = qfixed0;
-			for(auto& qfixedi : qfixed) {
-				qfixedi.second *= finc/(double)fincmax;
-				normF += pow(qfixedi.second, 2.0);
-			}
-            Assembling(R, qfixed, nodetoglobal);
-
-			double normR = std::inner_product(R.begin(), R.end(), R.begin(), 0.0);
-            normF = sqrt(normF);
-			if (normR/normF < 1.0e-10) {
-				std::cout << "k = " << k << "\tNorm = " << normR/normF << std::endl;
-				break;
-			}
-			
-			CSR<double> Kmod = CSR<double>(K);
-			std::vector<double> result = ScalingCG(Kmod, R, 100000, 1.0e-10);
-			std::vector<Vector<double> > du = std::vector<Vector<double> >(x.size(), Vector<double>(3));
-			Disassembling(du, result, nodetoglobal);
-			
-            for(int i = 0; i < x.size(); i++){
-				u[i] += du[i];
-			}
+	LoadControl<double> control = LoadControl<double>(LoadControlMethod::ARCLENGTH, 0.01, 1.0e-4, 0.25, 5, 20, 1.0e-10);
+	for (int finc = 1; control.LOADFACTOR() < 1.0; finc++) {
+		bool isconverged = control.Step(
+			//----------Residual----------
+			[&](std::vector<double>& _R) {
+				_R = std::vector<double>(KDEGREE, 0.0);
+				AssemblingParallel(_R, nodetoglobal, elements, [&](Vector<double>& _Qe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, int _i) {
+					SolidTotalLagrangeResidual<double, ShapeFunction8Cubic, Gauss8Cubic >(_Qe, _nodetoelement, elements[_i], { 0, 1, 2, }, x, u, 1000.0, 0.3);
+				});
+			},
+			//----------Tangent and residual----------
+			[&](std::vector<double>& _R) {
+				LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE);
+				_R = std::vector<double>(KDEGREE, 0.0);
+				for (auto element : elements) {
+					std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+					Matrix<double> Ke;
+					Vector<double> Qe;
+					SolidTotalLagrange<double, ShapeFunction8Cubic, Gauss8Cubic >(Ke, Qe, nodetoelement, element, { 0, 1, 2, }, x, u, 1000.0, 0.3);
+					Assembling(K, _R, u, Ke, Qe, nodetoglobal, nodetoelement, element);
+				}
+				return CSR<double>(K);
+			},
+			//----------Update----------
+			[&](const std::vector<double>& _du) {
+				std::vector<Vector<double> > du = std::vector<Vector<double> >(x.size(), Vector<double>(3));
+				Disassembling(du, _du, nodetoglobal);
+				for(int i = 0; i < x.size(); i++){
+					u[i] += du[i];
+				}
+			},
+			F
+		);
+		if (!isconverged) {
+			std::cout << "Increment is too small" << std::endl;
+			break;
 		}
+		std::cout << "finc = " << finc << "\tlambda = " << control.LOADFACTOR() << "\tk = " << control.ITERATIONS() << std::endl;
 
 		std::ofstream fout(model_path + "result" + std::to_string(finc) + ".vtk");
 		MakeHeadderToVTK(fout);
@@ -9,7 +9,7 @@
 #include "../../src/FEM/Controller/GaussIntegration.h"
 #include "../../src/FEM/Controller/BoundaryCondition.h"
 #include "../../src/FEM/Controller/Assembling.h"
-#include "../../src/LinearAlgebra/Solvers/CG.h"
+#include "../../src/LinearAlgebra/Solvers/BlockPreconditioner.h"
 #include "../../src/PrePost/Export/ExportToVTK.h"
 
 
@@ -22,13 +22,13 @@ int main() {
     std::vector<std::vector<int> > elementsu = mesh.GenerateElements2();
 	std::vector<std::vector<int> > elementsp = mesh.GenerateElements();
     std::vector<std::pair<std::pair<int, int>, double> > ufixed0 = mesh.GenerateFixedlist2({ 0, 1 }, [](Vector<double> _x){
-        if(abs(_x(0)) < 1.0e-5 || abs(_x(1)) < 1.0e-5 || abs(_x(0) - 1.0) < 1.0e-5 || abs(_x(1) - 1.0) < 1.0e-5) {
+        if(fabs(_x(0)) < 1.0e-5 || fabs(_x(1)) < 1.0e-5 || fabs(_x(0) - 1.0) < 1.0e-5 || fabs(_x(1) - 1.0) < 1.0e-5) {
             return true;
         }
         return false;
     });
 	std::vector<std::pair<std::pair<int, int>, double> > ufixed1 = mesh.GenerateFixedlist2({ 0 }, [](Vector<double> _x){
-        if(abs(_x(1) - 1.0) < 1.0e-5) {
+        if(fabs(_x(1) - 1.0) < 1.0e-5) {
             return true;
         }
         return false;
@@ -36,23 +36,45 @@ int main() {
 	for(auto& ufixed1i : ufixed1) {
 		ufixed1i.second = 1.0;
 	}
+
+	//----------Fix pressure of nodes which are not vertices of pressure elements and one vertex for uniqueness----------
+	std::vector<bool> ispressurenode = std::vector<bool>(x.size(), false);
+	for(auto& elementp : elementsp) {
+		for(auto i : elementp) {
+			ispressurenode[i] = true;
+		}
+	}
+	std::vector<std::pair<std::pair<int, int>, double> > pfixed = { { { elementsp[0][0], 2 }, 0.0 } };
+	for(int i = 0; i < x.size(); i++) {
+		if(!ispressurenode[i]) {
+			pfixed.push_back({ { i, 2 }, 0.0 });
+		}
+	}
 	
     std::vector<Vector<double> > up = std::vector<Vector<double> >(x.size(), Vector<double>(3));
 	std::vector<std::vector<int> > nodetoglobal = std::vector<std::vector<int> >(x.size(), std::vector<int>(3, 0));
 	
 	SetDirichlet(up, nodetoglobal, ufixed0);
 	SetDirichlet(up, nodetoglobal, ufixed1);
-	int KDEGREE = Renumbering(nodetoglobal);
+	SetDirichlet(up, nodetoglobal, pfixed);
+	int KDEGREE = Renumbering(nodetoglobal, { { 0, 1 }, { 2 } });		//  Pressure is numbered after velocity for block preconditioner
+	int UDEGREE = CountDegree(nodetoglobal, { 0, 1 });
     
+    double mu = 1.0;
     LILCSR<double> K = LILCSR<double>(KDEGREE, KDEGREE); 
+    LILCSR<double> S = LILCSR<double>(KDEGREE, KDEGREE); 
     std::vector<double> F = std::vector<double>(KDEGREE, 0.0);
 
     for (int i = 0; i < elementsu.size(); i++) {
         std::vector<std::vector<std::pair<int, int> > > nodetoelementu;
         std::vector<std::vector<std::pair<int, int> > > nodetoelementp;
         Matrix<double> Ke;
-        StokesStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, 1.0);
+        StokesStiffness<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Ke, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, mu);
         Assembling(K, F, up, Ke, nodetoglobal, { nodetoelementu, nodetoelementp }, { elementsu[i], elementsp[i] });
+		Matrix<double> Me;
+		std::vector<double> dummy = std::vector<double>(KDEGREE, 0.0);
+		StokesPressureMass<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Me, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, -1.0/mu);
+		Assembling(S, dummy, up, Me, nodetoglobal, { nodetoelementu, nodetoelementp }, { elementsu[i], elementsp[i] });
 		Vector<double> Fe;
 		StokesBodyForce<double, ShapeFunction8Square, ShapeFunction4Square, Gauss9Square>(Fe, nodetoelementu, elementsu[i], nodetoelementp, elementsp[i], { 0, 1, 2 }, x, [](Vector<double> _x){
 			Vector<double> f = { 0.0, 0.0};
@@ -76,8 +98,11 @@ int main() {
         Assembling(F, Fe, nodetoglobal, nodetoelementp, edgesp[i]);
 	}*/
 
+    //----------Solve with FGMRES and block preconditioner, S = -Mp/mu approximates Schur complement----------
     CSR<double> Kmod = CSR<double>(K);
-    std::vector<double> result = CG(Kmod, F, 100000, 1.0e-10);
+    CSR<double> Smod = SubMatrix(CSR<double>(S), UDEGREE, KDEGREE, UDEGREE, KDEGREE);
+    BlockTriangularPreconditioner<double> P = BlockTriangularPreconditioner<double>(Kmod, UDEGREE, Smod);
+    std::vector<double> result = FGMRES(Kmod, P, F, 100, 100000, 1.0e-10);
     Disassembling(up, result, nodetoglobal);
 
 	std::vector<Vector<double> > u = std::vector<Vector<double> >(x.size());
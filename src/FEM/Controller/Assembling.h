@@ -9,6 +9,7 @@
 #pragma once
 #include <vector>
 #include <cassert>
+#include <omp.h>
 
 
 #include "../../LinearAlgebra/Models/LILCSR.h"
@@ -147,6 +148,56 @@ namespace PANSFEM2 {
     }
 
 
+    //********************Assembling lumped global matrix as vector from element matrix********************
+    //  Row sums of _Ke are added to the diagonal _M, so no global matrix is made.
+    template<class T>
+    void AssemblingLumped(std::vector<T>& _M, Matrix<T>& _Ke, const std::vector<std::vector<int> >& _nodetoglobal, const std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        for(int i = 0; i < _element.size(); i++) {
+            for(auto doui : _nodetoelement[i]) {
+                if(_nodetoglobal[_element[i]][doui.first] != -1) {
+                    for(int j = 0; j < _element.size(); j++) {
+                        for(auto douj : _nodetoelement[j]) {
+                            _M[_nodetoglobal[_element[i]][doui.first]] += _Ke(doui.second, douj.second);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+    //********************Assembling global vector from element vectors in parallel********************
+    //  _kernel(Fe, nodetoelement, i) makes element vector of i-th element.
+    //  Each thread adds into its own buffer, and buffers are summed in thread order for reproducibility.
+    template<class T, class F>
+    void AssemblingParallel(std::vector<T>& _F, const std::vector<std::vector<int> >& _nodetoglobal, const std::vector<std::vector<int> >& _elements, F _kernel) {
+        int nthreads = omp_get_max_threads();
+        std::vector<std::vector<T> > Fthreads = std::vector<std::vector<T> >(nthreads);
+
+#pragma omp parallel
+        {
+            std::vector<T>& Fthread = Fthreads[omp_get_thread_num()];
+            Fthread = std::vector<T>(_F.size(), T());
+#pragma omp for
+            for(int i = 0; i < _elements.size(); i++) {
+                std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+                Vector<T> Fe;
+                _kernel(Fe, nodetoelement, i);
+                Assembling(Fthread, Fe, _nodetoglobal, nodetoelement, _elements[i]);
+            }
+        }
+
+#pragma omp parallel for
+        for(int i = 0; i < _F.size(); i++) {
+            for(int j = 0; j < nthreads; j++) {
+                if(Fthreads[j].size() == _F.size()) {
+                    _F[i] += Fthreads[j][i];
+                }
+            }
+        }
+    }
+
+
     //********************Assembling Neumann boundary conditions********************
     template<class T>
     void Assembling(std::vector<T>& _F, const std::vector<std::pair<std::pair<int, int>, T> >& _f, const std::vector<std::vector<int> >& _nodetoglobal) {
@@ -184,4 +235,38 @@ namespace PANSFEM2 {
         }
         return KDEGREE;
     }
+
+
+    //********************Renumbering global number block by block of dofs********************
+    //  Dofs in _doulists[0] of all nodes are numbered first, then _doulists[1] and so on,
+    //  e.g. { { 0, 1 }, { 2 } } places pressure after velocity of mixed problems.
+    int Renumbering(std::vector<std::vector<int> >& _nodetoglobal, const std::vector<std::vector<int> >& _doulists) {
+        int KDEGREE = 0;
+        for(auto& doulist : _doulists) {
+            for(auto& node : _nodetoglobal) {
+                for(auto dou : doulist) {
+                    if(node[dou] != -1) {
+                        node[dou] = KDEGREE;
+                        KDEGREE++;
+                    }
+                }
+            }
+        }
+        return KDEGREE;
+    }
+
+
+    //********************Count free dofs in _doulist********************
+    //  e.g. { 0, 1 } gives number of velocity dofs, which are [0, count) after Renumbering with { { 0, 1 }, { 2 } }.
+    int CountDegree(const std::vector<std::vector<int> >& _nodetoglobal, const std::vector<int>& _doulist) {
+        int count = 0;
+        for(auto& node : _nodetoglobal) {
+            for(auto dou : _doulist) {
+                if(node[dou] != -1) {
+                    count++;
+                }
+            }
+        }
+        return count;
+    }
 }
\ No newline at end of file
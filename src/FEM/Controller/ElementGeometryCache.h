@@ -0,0 +1,133 @@
+//*****************************************************************************
+//Title		:PANSFEM2/FEM/Controller/ElementGeometryCache.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/18
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cassert>
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "ReferenceElement.h"
+
+
+namespace PANSFEM2 {
+	//********************Cache of element geometry at integration points********************
+	//	Stores dXdr^-1, dNdX and J*w of every element at every integration point for a fixed mesh.
+	//	Call Update() again (or Invalidate()) whenever nodal coordinates are changed.
+	template<class T, template<class>class SF, template<class>class IC>
+	class ElementGeometryCache{
+public:
+		ElementGeometryCache();
+		ElementGeometryCache(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements);
+
+
+		void Update(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements);
+		void Invalidate();
+		bool IsValid() const;
+		int SIZE() const;
+
+
+		const Matrix<T>& drdX(int _id, int _g) const;		//Inverse of Jacobian matrix dXdr
+		const Matrix<T>& dNdX(int _id, int _g) const;		//Shape function derivatives on global cordinate
+		T JW(int _id, int _g) const;						//Jacobian times weights of integration point
+
+
+private:
+		bool isvalid;					//Cache is consistent with coordinates or not
+		int ne;							//Number of elements
+		std::vector<Matrix<T> > drdx;	//Inverse of Jacobian matrix [id*IC<T>::N + g]
+		std::vector<Matrix<T> > dndx;	//dNdX [id*IC<T>::N + g]
+		std::vector<T> jw;				//J*w [id*IC<T>::N + g]
+	};
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	ElementGeometryCache<T, SF, IC>::ElementGeometryCache() {
+		this->isvalid = false;
+		this->ne = 0;
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	ElementGeometryCache<T, SF, IC>::ElementGeometryCache(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements) {
+		this->Update(_x, _elements);
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	void ElementGeometryCache<T, SF, IC>::Update(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements) {
+		this->ne = _elements.size();
+		this->drdx = std::vector<Matrix<T> >(this->ne*IC<T>::N);
+		this->dndx = std::vector<Matrix<T> >(this->ne*IC<T>::N);
+		this->jw = std::vector<T>(this->ne*IC<T>::N);
+
+#pragma omp parallel for
+		for (int id = 0; id < this->ne; id++) {
+			assert(_elements[id].size() == SF<T>::n);
+
+			Matrix<T> X = Matrix<T>(SF<T>::n, SF<T>::d);
+			for (int i = 0; i < SF<T>::n; i++) {
+				for (int j = 0; j < SF<T>::d; j++) {
+					X(i, j) = _x[_elements[id][i]](j);
+				}
+			}
+
+			for (int g = 0; g < IC<T>::N; g++) {
+				const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+				Matrix<T> dXdr = dNdr*X;
+				T w = dXdr.Determinant();
+				for (int k = 0; k < SF<T>::d; k++) {
+					w *= IC<T>::Weights[g][k];
+				}
+				this->drdx[id*IC<T>::N + g] = dXdr.Inverse();
+				this->dndx[id*IC<T>::N + g] = this->drdx[id*IC<T>::N + g]*dNdr;
+				this->jw[id*IC<T>::N + g] = w;
+			}
+		}
+
+		this->isvalid = true;
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	void ElementGeometryCache<T, SF, IC>::Invalidate() {
+		this->isvalid = false;
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	bool ElementGeometryCache<T, SF, IC>::IsValid() const {
+		return this->isvalid;
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	int ElementGeometryCache<T, SF, IC>::SIZE() const {
+		return this->ne;
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	const Matrix<T>& ElementGeometryCache<T, SF, IC>::drdX(int _id, int _g) const {
+		assert(this->isvalid && 0 <= _id && _id < this->ne && 0 <= _g && _g < IC<T>::N);
+		return this->drdx[_id*IC<T>::N + _g];
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	const Matrix<T>& ElementGeometryCache<T, SF, IC>::dNdX(int _id, int _g) const {
+		assert(this->isvalid && 0 <= _id && _id < this->ne && 0 <= _g && _g < IC<T>::N);
+		return this->dndx[_id*IC<T>::N + _g];
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	T ElementGeometryCache<T, SF, IC>::JW(int _id, int _g) const {
+		assert(this->isvalid && 0 <= _id && _id < this->ne && 0 <= _g && _g < IC<T>::N);
+		return this->jw[_id*IC<T>::N + _g];
+	}
+}
@@ -0,0 +1,268 @@
+//*****************************************************************************
+//Title		:src/FEM/Controller/JacobianFreeNewtonKrylov.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/18
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <numeric>
+#include <limits>
+#include <iostream>
+#include <algorithm>
+
+
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+#include "../../LinearAlgebra/Solvers/GMRES.h"
+#include "../../LinearAlgebra/Solvers/BlockPreconditioner.h"
+
+
+namespace PANSFEM2 {
+	//********************Jacobian-free Newton-Krylov solver for R(u) = 0********************
+	//	Callbacks :
+	//		_residual(R)		make residual R at current state
+	//		_preconditioner()	return approximate tangent P ~ -dR/du in CSR at current state,
+	//							or BlockTriangularPreconditioner made from it for saddle point problems
+	//		_update(du)			add du to current state
+	//	Tangent is never assembled. K*v is approximated by (R(u) - R(u + h*v))/h and
+	//	FGMRES(m) is preconditioned by ILU(0) of P or by given block preconditioner,
+	//	which is reused for _reform iterations.
+	//	Tolerance of each linear solve is chosen by Eisenstat-Walker forcing term.
+	template<class T>
+	class JacobianFreeNewtonKrylov {
+public:
+		JacobianFreeNewtonKrylov();
+		JacobianFreeNewtonKrylov(int _itrmax, T _eps = 1.0e-8);
+
+
+		void SetReform(int _reform);				//Iterations between preconditioner reforms (0 : once in each Solve)
+		void SetForcingTerm(T _etamax, T _gamma = 0.9);
+		void SetPerturbation(T _scale);				//Typical norm of state for difference step h
+		void SetLinearSolver(int _itrmax, int _restart = 100);
+		void SetVerbose(bool _isverbose);
+
+		template<class FR, class FP, class FU>
+		bool Solve(FR _residual, FP _preconditioner, FU _update, T _normF);
+
+		int ITERATIONS() const;						//Newton iterations of last Solve
+		int RESIDUALS() const;						//Residual evaluations of last Solve
+		int REFORMS() const;						//Preconditioner reforms of last Solve
+		T NORM() const;								//|R|/normF of last Solve
+
+
+private:
+		int itrmax;
+		T eps;
+		int reform;
+		T etamax, gamma;
+		T scale;
+		int solveritrmax, restart;
+		bool isverbose;
+
+		int iterations, residuals, reforms;
+		T norm;
+
+		CSR<T> M;									//ILU(0) of preconditioner
+		BlockTriangularPreconditioner<T> B;			//Block preconditioner
+		bool isblock;
+		GMRESWorkspace<T> work;
+
+
+		void MakePreconditioner(CSR<T>& _P);
+		void MakePreconditioner(const BlockTriangularPreconditioner<T>& _P);
+	};
+
+
+	template<class T>
+	JacobianFreeNewtonKrylov<T>::JacobianFreeNewtonKrylov() : JacobianFreeNewtonKrylov(100) {}
+
+
+	template<class T>
+	JacobianFreeNewtonKrylov<T>::JacobianFreeNewtonKrylov(int _itrmax, T _eps) {
+		this->itrmax = _itrmax;
+		this->eps = _eps;
+		this->reform = 0;
+		this->etamax = 0.1;
+		this->gamma = 0.9;
+		this->scale = 1.0;
+		this->solveritrmax = 1000;
+		this->restart = 100;
+		this->isverbose = false;
+		this->iterations = 0;
+		this->residuals = 0;
+		this->reforms = 0;
+		this->norm = T();
+		this->isblock = false;
+	}
+
+
+	template<class T>
+	void JacobianFreeNewtonKrylov<T>::SetReform(int _reform) {
+		assert(_reform >= 0);
+		this->reform = _reform;
+	}
+
+
+	template<class T>
+	void JacobianFreeNewtonKrylov<T>::SetForcingTerm(T _etamax, T _gamma) {
+		assert(0.0 < _etamax && _etamax < 1.0 && 0.0 < _gamma && _gamma <= 1.0);
+		this->etamax = _etamax;
+		this->gamma = _gamma;
+	}
+
+
+	template<class T>
+	void JacobianFreeNewtonKrylov<T>::SetPerturbation(T _scale) {
+		assert(_scale >= T());
+		this->scale = _scale;
+	}
+
+
+	template<class T>
+	void JacobianFreeNewtonKrylov<T>::SetLinearSolver(int _itrmax, int _restart) {
+		assert(_restart > 0);
+		this->solveritrmax = _itrmax;
+		this->restart = _restart;
+	}
+
+
+	template<class T>
+	void JacobianFreeNewtonKrylov<T>::SetVerbose(bool _isverbose) {
+		this->isverbose = _isverbose;
+	}
+
+
+	template<class T>
+	template<class FR, class FP, class FU>
+	bool JacobianFreeNewtonKrylov<T>::Solve(FR _residual, FP _preconditioner, FU _update, T _normF) {
+		this->iterations = 0;
+		this->residuals = 0;
+		this->reforms = 0;
+
+		std::vector<T> R;
+		T normRold = T(), eta = this->etamax;
+		int lastreform = 0;
+
+		for (int k = 0; k <= this->itrmax; k++) {
+			//----------Check convergence----------
+			_residual(R);
+			this->residuals++;
+			T normR = sqrt(std::inner_product(R.begin(), R.end(), R.begin(), T()));
+			this->iterations = k;
+			this->norm = normR/_normF;
+			if (this->isverbose) {
+				std::cout << "\tk = " << k << "\tNorm = " << this->norm << "\teta = " << eta << std::endl;
+			}
+			if (this->norm < this->eps) {
+				return true;
+			}
+			if (k == this->itrmax || !std::isfinite(this->norm)) {
+				break;
+			}
+
+			//----------Make preconditioner----------
+			if (k == 0 || (this->reform > 0 && k - lastreform >= this->reform)) {
+				auto P = _preconditioner();
+				this->MakePreconditioner(P);
+				lastreform = k;
+				this->reforms++;
+			}
+
+			//----------Choose forcing term----------
+			if (k > 0) {
+				T etaold = eta;
+				eta = this->gamma*pow(normR/normRold, 2.0);
+				if (this->gamma*etaold*etaold > 0.1) {
+					eta = std::max(eta, this->gamma*etaold*etaold);
+				}
+				eta = std::min(this->etamax, std::max(eta, 0.5*this->eps*_normF/normR));
+			}
+			normRold = normR;
+
+			//----------Solve K*du = R with directional difference----------
+			if (this->work.N != R.size() || this->work.M != this->restart) {
+				this->work = GMRESWorkspace<T>(R.size(), this->restart, true);
+			}
+			std::vector<T> du = std::vector<T>(R.size(), T());
+			GMRES(
+				[&](const std::vector<T>& _v, std::vector<T>& _Kv) {
+					T normv = sqrt(std::inner_product(_v.begin(), _v.end(), _v.begin(), T()));
+					if (normv == T()) {
+						std::fill(_Kv.begin(), _Kv.end(), T());
+						return;
+					}
+					T h = sqrt(std::numeric_limits<T>::epsilon())*(1.0 + this->scale)/normv;
+					std::vector<T> hv = _v;
+					for (auto& hvi : hv) {
+						hvi *= h;
+					}
+					std::vector<T> Rh;
+					_update(hv);
+					_residual(Rh);
+					this->residuals++;
+					for (auto& hvi : hv) {
+						hvi = -hvi;
+					}
+					_update(hv);
+					for (int i = 0; i < R.size(); i++) {
+						_Kv[i] = (R[i] - Rh[i])/h;
+					}
+				},
+				[&](const std::vector<T>& _v, std::vector<T>& _Mv) {
+					if (this->isblock) {
+						this->B(_v, _Mv);
+					} else {
+						PreILU0(this->M, _v, _Mv);
+					}
+				},
+				R, du, this->solveritrmax, eta, this->work
+			);
+			_update(du);
+		}
+
+		return false;
+	}
+
+
+	template<class T>
+	void JacobianFreeNewtonKrylov<T>::MakePreconditioner(CSR<T>& _P) {
+		this->M = ILU0(_P);
+		this->isblock = false;
+	}
+
+
+	template<class T>
+	void JacobianFreeNewtonKrylov<T>::MakePreconditioner(const BlockTriangularPreconditioner<T>& _P) {
+		this->B = _P;
+		this->isblock = true;
+	}
+
+
+	template<class T>
+	int JacobianFreeNewtonKrylov<T>::ITERATIONS() const {
+		return this->iterations;
+	}
+
+
+	template<class T>
+	int JacobianFreeNewtonKrylov<T>::RESIDUALS() const {
+		return this->residuals;
+	}
+
+
+	template<class T>
+	int JacobianFreeNewtonKrylov<T>::REFORMS() const {
+		return this->reforms;
+	}
+
+
+	template<class T>
+	T JacobianFreeNewtonKrylov<T>::NORM() const {
+		return this->norm;
+	}
+}
@@ -0,0 +1,359 @@
+//*****************************************************************************
+//Title		:src/FEM/Controller/LoadControl.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/18
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+#include "NewtonRaphson.h"
+
+
+namespace PANSFEM2 {
+	//********************Type of increment control********************
+	enum class LoadControlMethod {
+		LOAD,			//Load factor is prescribed and solved by NewtonRaphson
+		ARCLENGTH		//Load factor is unknown and constrained by Crisfield arc-length
+	};
+
+
+	//********************Adaptive incremental solver for R(u, lambda) = lambda*F + R0(u) = 0********************
+	//	Callbacks :
+	//		_residual(R0)		make residual R0 = -Q(u) without external load at current state
+	//		_tangent(R0)		make R0 and return tangent K = -dR0/du in CSR at current state
+	//		_update(du)			add du to current state
+	//	Increment is multiplied by sqrt(itrdesired/iterations) after convergence and halved after failure.
+	//	The state is rolled back by _update(-Du) when an increment fails.
+	//	Both methods stop at lambda = 1; an arc-length increment passing over it is redone as a load increment to lambda = 1.
+	template<class T>
+	class LoadControl {
+public:
+		LoadControl();
+		LoadControl(LoadControlMethod _method, T _dlambda, T _dlambdamin, T _dlambdamax, int _itrdesired = 5, int _itrmax = 20, T _eps = 1.0e-8, bool _issymmetric = true);
+
+
+		void SetArcLengthScaling(T _psi);			//Weight of load term in arc-length constraint (0 : cylindrical)
+		void SetLinearSolver(int _itrmax, T _eps);
+		void SetVerbose(bool _isverbose);
+		NewtonRaphson<T>& GetNewtonRaphson();		//Solver of LOAD for changing tangent update
+
+		template<class FR, class FK, class FU>
+		bool Step(FR _residual, FK _tangent, FU _update, const std::vector<T>& _F);
+
+		T LOADFACTOR() const;						//Load factor of last converged state
+		T INCREMENT() const;						//Load factor increment of last converged step
+		int ITERATIONS() const;						//Iterations of last converged step
+		int STEPS() const;							//Number of converged steps
+		int CUTS() const;							//Number of failed and cut back steps
+
+
+private:
+		LoadControlMethod method;
+		T dlambda, dlambdamin, dlambdamax;			//Load factor increment and its bounds for LOAD
+		T dl, dlmin, dlmax;							//Arc-length and its bounds for ARCLENGTH
+		int itrdesired, itrmax;
+		T eps;
+		bool issymmetric;
+		T psi;
+		int solveritrmax;
+		T solvereps;
+		bool isverbose;
+
+		T lambda, Dlambdaold;						//Load factor and its last increment
+		std::vector<T> Duold;						//Last converged displacement increment
+		int iterations, steps, cuts;
+		NewtonRaphson<T> newton;
+
+
+		template<class FR, class FK, class FU>
+		bool StepLoad(FR _residual, FK _tangent, FU _update, const std::vector<T>& _F, std::vector<T>& _Du, T& _Dlambda);
+		template<class FR, class FK, class FU>
+		bool StepArcLength(FR _residual, FK _tangent, FU _update, const std::vector<T>& _F, std::vector<T>& _Du, T& _Dlambda);
+		std::vector<T> SolveTangent(CSR<T>& _K, const std::vector<T>& _D, const std::vector<T>& _b);
+	};
+
+
+	template<class T>
+	LoadControl<T>::LoadControl() : LoadControl(LoadControlMethod::LOAD, 1.0, 1.0, 1.0) {}
+
+
+	template<class T>
+	LoadControl<T>::LoadControl(LoadControlMethod _method, T _dlambda, T _dlambdamin, T _dlambdamax, int _itrdesired, int _itrmax, T _eps, bool _issymmetric) {
+		assert(0.0 < _dlambdamin && _dlambdamin <= _dlambda && _dlambda <= _dlambdamax && 0 < _itrdesired);
+		this->method = _method;
+		this->dlambda = _dlambda;
+		this->dlambdamin = _dlambdamin;
+		this->dlambdamax = _dlambdamax;
+		this->dl = T();
+		this->dlmin = T();
+		this->dlmax = T();
+		this->itrdesired = _itrdesired;
+		this->itrmax = _itrmax;
+		this->eps = _eps;
+		this->issymmetric = _issymmetric;
+		this->psi = T();
+		this->solveritrmax = 100000;
+		this->solvereps = 1.0e-10;
+		this->isverbose = false;
+		this->lambda = T();
+		this->Dlambdaold = T();
+		this->iterations = 0;
+		this->steps = 0;
+		this->cuts = 0;
+		this->newton = NewtonRaphson<T>(NewtonMethod::FULL, _itrmax, _eps, _issymmetric);
+	}
+
+
+	template<class T>
+	void LoadControl<T>::SetArcLengthScaling(T _psi) {
+		assert(_psi >= T());
+		this->psi = _psi;
+	}
+
+
+	template<class T>
+	void LoadControl<T>::SetLinearSolver(int _itrmax, T _eps) {
+		this->solveritrmax = _itrmax;
+		this->solvereps = _eps;
+		this->newton.SetLinearSolver(_itrmax, _eps);
+	}
+
+
+	template<class T>
+	void LoadControl<T>::SetVerbose(bool _isverbose) {
+		this->isverbose = _isverbose;
+		this->newton.SetVerbose(_isverbose);
+	}
+
+
+	template<class T>
+	NewtonRaphson<T>& LoadControl<T>::GetNewtonRaphson() {
+		return this->newton;
+	}
+
+
+	template<class T>
+	template<class FR, class FK, class FU>
+	bool LoadControl<T>::Step(FR _residual, FK _tangent, FU _update, const std::vector<T>& _F) {
+		while (true) {
+			std::vector<T> Du = std::vector<T>(_F.size(), T());
+			T Dlambda = T();
+			bool isconverged = this->method == LoadControlMethod::LOAD ? this->StepLoad(_residual, _tangent, _update, _F, Du, Dlambda) : this->StepArcLength(_residual, _tangent, _update, _F, Du, Dlambda);
+
+			//----------Replace arc-length increment passing over lambda = 1 by load increment to lambda = 1----------
+			bool isfinal = this->method == LoadControlMethod::LOAD ? this->lambda + Dlambda >= (T)1.0 : false;
+			if (isconverged && this->method == LoadControlMethod::ARCLENGTH && this->lambda < (T)1.0 && this->lambda + Dlambda > (T)1.0) {
+				for (auto& Dui : Du) {
+					Dui = -Dui;
+				}
+				_update(Du);
+				Du = std::vector<T>(_F.size(), T());
+				T dlambdaarc = this->dlambda;
+				this->dlambda = (T)1.0 - this->lambda;
+				isconverged = this->StepLoad(_residual, _tangent, _update, _F, Du, Dlambda);
+				this->dlambda = dlambdaarc;
+				isfinal = true;
+			}
+
+			//----------Accept and enlarge or shrink next increment----------
+			if (isconverged) {
+				this->lambda = isfinal ? (T)1.0 : this->lambda + Dlambda;
+				this->Dlambdaold = Dlambda;
+				this->Duold = Du;
+				this->steps++;
+				T ratio = std::max((T)0.5, std::min((T)2.0, sqrt(this->itrdesired/(T)std::max(this->iterations, 1))));
+				if (this->method == LoadControlMethod::LOAD) {
+					this->dlambda = std::max(this->dlambdamin, std::min(this->dlambdamax, this->dlambda*ratio));
+				} else {
+					this->dl = std::max(this->dlmin, std::min(this->dlmax, this->dl*ratio));
+				}
+				return true;
+			}
+
+			//----------Roll back and cut increment----------
+			for (auto& Dui : Du) {
+				Dui = -Dui;
+			}
+			_update(Du);
+			this->cuts++;
+			if (this->isverbose) {
+				std::cout << "\tcut back" << std::endl;
+			}
+			if (this->method == LoadControlMethod::LOAD) {
+				if (this->dlambda <= this->dlambdamin) {
+					return false;
+				}
+				this->dlambda = std::max(this->dlambdamin, 0.5*this->dlambda);
+			} else {
+				if (this->dl <= this->dlmin) {
+					return false;
+				}
+				this->dl = std::max(this->dlmin, 0.5*this->dl);
+			}
+		}
+	}
+
+
+	template<class T>
+	T LoadControl<T>::LOADFACTOR() const {
+		return this->lambda;
+	}
+
+
+	template<class T>
+	T LoadControl<T>::INCREMENT() const {
+		return this->Dlambdaold;
+	}
+
+
+	template<class T>
+	int LoadControl<T>::ITERATIONS() const {
+		return this->iterations;
+	}
+
+
+	template<class T>
+	int LoadControl<T>::STEPS() const {
+		return this->steps;
+	}
+
+
+	template<class T>
+	int LoadControl<T>::CUTS() const {
+		return this->cuts;
+	}
+
+
+	template<class T>
+	template<class FR, class FK, class FU>
+	bool LoadControl<T>::StepLoad(FR _residual, FK _tangent, FU _update, const std::vector<T>& _F, std::vector<T>& _Du, T& _Dlambda) {
+		//----------Do not step over lambda = 1----------
+		_Dlambda = std::min(this->dlambda, (T)1.0 - this->lambda);
+		assert(_Dlambda > T());
+		T lambdanext = this->lambda + _Dlambda;
+		T normF = lambdanext*sqrt(std::inner_product(_F.begin(), _F.end(), _F.begin(), T()));
+
+		bool isconverged = this->newton.Solve(
+			[&](std::vector<T>& _R) {
+				_residual(_R);
+				xexpay(_R, lambdanext, _F);
+			},
+			[&](std::vector<T>& _R) {
+				CSR<T> K = _tangent(_R);
+				xexpay(_R, lambdanext, _F);
+				return K;
+			},
+			[&](const std::vector<T>& _du) {
+				xexpay(_Du, (T)1.0, _du);
+				_update(_du);
+			},
+			normF
+		);
+		this->iterations = this->newton.ITERATIONS();
+		return isconverged;
+	}
+
+
+	template<class T>
+	template<class FR, class FK, class FU>
+	bool LoadControl<T>::StepArcLength(FR _residual, FK _tangent, FU _update, const std::vector<T>& _F, std::vector<T>& _Du, T& _Dlambda) {
+		T FF = std::inner_product(_F.begin(), _F.end(), _F.begin(), T());
+		T psi2FF = this->psi*this->psi*FF;
+		std::vector<T> R;
+
+		//----------Predictor along tangent K*uF = F----------
+		CSR<T> K = _tangent(R);
+		std::vector<T> D = GetDiagonal(K);
+		std::vector<T> uF = this->SolveTangent(K, D, _F);
+		T uFuF = std::inner_product(uF.begin(), uF.end(), uF.begin(), T());
+		if (this->steps == 0 && this->dl == T()) {
+			T scale = sqrt(uFuF + psi2FF);
+			this->dl = this->dlambda*scale;
+			this->dlmin = this->dlambdamin*scale;
+			this->dlmax = this->dlambdamax*scale;
+		}
+
+		//  Keep direction of previous increment to follow the path over limit points
+		T sign = 1.0;
+		if (!this->Duold.empty()) {
+			sign = std::inner_product(uF.begin(), uF.end(), this->Duold.begin(), T()) + psi2FF*this->Dlambdaold >= T() ? 1.0 : -1.0;
+		}
+		_Dlambda = sign*this->dl/sqrt(uFuF + psi2FF);
+		_Du = uF;
+		for (auto& Dui : _Du) {
+			Dui *= _Dlambda;
+		}
+		_update(_Du);
+
+		//----------Corrector on sphere |Du|^2 + psi^2*Dlambda^2*|F|^2 = dl^2----------
+		for (int k = 1; k <= this->itrmax; k++) {
+			_residual(R);
+			T lambdanext = this->lambda + _Dlambda;
+			xexpay(R, lambdanext, _F);
+			T norm = sqrt(std::inner_product(R.begin(), R.end(), R.begin(), T()))/(std::max(fabs(lambdanext), (T)1.0e-3)*sqrt(FF));
+			if (this->isverbose) {
+				std::cout << "\tk = " << k << "\tNorm = " << norm << "\tlambda = " << lambdanext << std::endl;
+			}
+			if (norm < this->eps) {
+				this->iterations = k;
+				return true;
+			}
+			if (!std::isfinite(norm)) {
+				return false;
+			}
+
+			K = _tangent(R);
+			xexpay(R, lambdanext, _F);
+			D = GetDiagonal(K);
+			uF = this->SolveTangent(K, D, _F);
+			std::vector<T> uR = this->SolveTangent(K, D, R);
+
+			//  a1*dlambda^2 + a2*dlambda + a3 = 0
+			std::vector<T> a = _Du;
+			xexpay(a, (T)1.0, uR);
+			T a1 = std::inner_product(uF.begin(), uF.end(), uF.begin(), T()) + psi2FF;
+			T a2 = 2.0*(std::inner_product(uF.begin(), uF.end(), a.begin(), T()) + psi2FF*_Dlambda);
+			T a3 = std::inner_product(a.begin(), a.end(), a.begin(), T()) + psi2FF*_Dlambda*_Dlambda - this->dl*this->dl;
+			T discriminant = a2*a2 - 4.0*a1*a3;
+			if (discriminant < T()) {
+				return false;
+			}
+
+			//  Choose root keeping the smallest angle to current increment
+			T dlambda = T(), anglemax = -std::numeric_limits<T>::max();
+			for (T root : { (-a2 + sqrt(discriminant))/(2.0*a1), (-a2 - sqrt(discriminant))/(2.0*a1) }) {
+				T angle = std::inner_product(a.begin(), a.end(), _Du.begin(), T()) + root*std::inner_product(uF.begin(), uF.end(), _Du.begin(), T()) + psi2FF*(_Dlambda + root)*_Dlambda;
+				if (angle > anglemax) {
+					anglemax = angle;
+					dlambda = root;
+				}
+			}
+
+			std::vector<T> du = uR;
+			xexpay(du, dlambda, uF);
+			xexpay(_Du, (T)1.0, du);
+			_Dlambda += dlambda;
+			_update(du);
+		}
+
+		return false;
+	}
+
+
+	template<class T>
+	std::vector<T> LoadControl<T>::SolveTangent(CSR<T>& _K, const std::vector<T>& _D, const std::vector<T>& _b) {
+		return this->issymmetric ? ScalingCG(_K, _D, _b, this->solveritrmax, this->solvereps) : ScalingBiCGSTAB(_K, _D, _b, this->solveritrmax, this->solvereps);
+	}
+}
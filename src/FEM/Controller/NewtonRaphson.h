@@ -0,0 +1,280 @@
+//*****************************************************************************
+//Title		:src/FEM/Controller/NewtonRaphson.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/18
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <numeric>
+#include <iostream>
+
+
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+
+
+namespace PANSFEM2 {
+	//********************Type of tangent update********************
+	enum class NewtonMethod {
+		FULL,			//Tangent is made at every iteration
+		MODIFIED,		//Tangent is made at every _reform iterations and reused
+		BFGS			//Tangent is made once and corrected by BFGS updates
+	};
+
+
+	//********************Newton-Raphson solver for R(u) = F - Q(u) = 0********************
+	//	Callbacks :
+	//		_residual(R)		make residual R at current state without tangent
+	//		_tangent(R)			make residual R and return tangent K = -dR/du in CSR at current state
+	//		_update(du)			add du to current state
+	//	Convergence is judged by |R|/_normF < eps.
+	template<class T>
+	class NewtonRaphson {
+public:
+		NewtonRaphson();
+		NewtonRaphson(NewtonMethod _method, int _itrmax = 100, T _eps = 1.0e-8, bool _issymmetric = true);
+
+
+		void SetReform(int _reform);				//Number of iterations between tangent reforms for MODIFIED
+		void SetMemory(int _memory);				//Maximum number of BFGS pairs before tangent reform
+		void SetLineSearch(bool _islinesearch, int _lsmax = 5, T _lsratio = 0.5);
+		void SetLinearSolver(int _itrmax, T _eps);
+		void SetVerbose(bool _isverbose);
+
+		template<class FR, class FK, class FU>
+		bool Solve(FR _residual, FK _tangent, FU _update, T _normF);
+
+		int ITERATIONS() const;						//Iterations of last Solve
+		int REFORMS() const;						//Tangent reforms of last Solve
+		T NORM() const;								//|R|/normF of last Solve
+
+
+private:
+		NewtonMethod method;
+		int itrmax;
+		T eps;
+		bool issymmetric;
+		int reform, memory;
+		bool islinesearch;
+		int lsmax;
+		T lsratio;
+		int solveritrmax;
+		T solvereps;
+		bool isverbose;
+
+		int iterations, reforms;
+		T norm;
+
+		CSR<T> K;									//Current tangent
+		std::vector<T> D;							//Diagonal of current tangent for scaling
+		std::vector<std::vector<T> > S, Y;			//BFGS pairs of step and residual change
+		std::vector<T> rho;							//1/(y.s) of BFGS pairs
+
+
+		std::vector<T> SolveTangent(const std::vector<T>& _R);
+		std::vector<T> SolveBFGS(const std::vector<T>& _R);
+	};
+
+
+	template<class T>
+	NewtonRaphson<T>::NewtonRaphson() : NewtonRaphson(NewtonMethod::FULL) {}
+
+
+	template<class T>
+	NewtonRaphson<T>::NewtonRaphson(NewtonMethod _method, int _itrmax, T _eps, bool _issymmetric) {
+		this->method = _method;
+		this->itrmax = _itrmax;
+		this->eps = _eps;
+		this->issymmetric = _issymmetric;
+		this->reform = 5;
+		this->memory = 20;
+		this->islinesearch = false;
+		this->lsmax = 5;
+		this->lsratio = 0.5;
+		this->solveritrmax = 100000;
+		this->solvereps = 1.0e-10;
+		this->isverbose = false;
+		this->iterations = 0;
+		this->reforms = 0;
+		this->norm = T();
+	}
+
+
+	template<class T>
+	void NewtonRaphson<T>::SetReform(int _reform) {
+		assert(_reform > 0);
+		this->reform = _reform;
+	}
+
+
+	template<class T>
+	void NewtonRaphson<T>::SetMemory(int _memory) {
+		assert(_memory > 0);
+		this->memory = _memory;
+	}
+
+
+	template<class T>
+	void NewtonRaphson<T>::SetLineSearch(bool _islinesearch, int _lsmax, T _lsratio) {
+		this->islinesearch = _islinesearch;
+		this->lsmax = _lsmax;
+		this->lsratio = _lsratio;
+	}
+
+
+	template<class T>
+	void NewtonRaphson<T>::SetLinearSolver(int _itrmax, T _eps) {
+		this->solveritrmax = _itrmax;
+		this->solvereps = _eps;
+	}
+
+
+	template<class T>
+	void NewtonRaphson<T>::SetVerbose(bool _isverbose) {
+		this->isverbose = _isverbose;
+	}
+
+
+	template<class T>
+	template<class FR, class FK, class FU>
+	bool NewtonRaphson<T>::Solve(FR _residual, FK _tangent, FU _update, T _normF) {
+		this->iterations = 0;
+		this->reforms = 0;
+		this->S.clear();
+		this->Y.clear();
+		this->rho.clear();
+
+		std::vector<T> R, Rprev, sprev;		//Residual, previous residual and previous step
+		bool hasR = false;					//R is already made at current state or not
+		int lastreform = 0;
+
+		for (int k = 0; k <= this->itrmax; k++) {
+			//----------Make tangent and/or residual at current state----------
+			bool isreform = k == 0
+				|| this->method == NewtonMethod::FULL
+				|| (this->method == NewtonMethod::MODIFIED && k - lastreform >= this->reform)
+				|| (this->method == NewtonMethod::BFGS && this->S.size() >= this->memory);
+			if (isreform) {
+				this->K = _tangent(R);
+				this->D = GetDiagonal(this->K);
+				this->S.clear();
+				this->Y.clear();
+				this->rho.clear();
+				lastreform = k;
+				this->reforms++;
+			} else if (!hasR) {
+				_residual(R);
+			}
+
+			//----------Add BFGS pair s = du, y = R_prev - R----------
+			if (this->method == NewtonMethod::BFGS && !isreform && !sprev.empty()) {
+				std::vector<T> y = subtract(Rprev, R);
+				T ys = std::inner_product(y.begin(), y.end(), sprev.begin(), T());
+				if (ys > T()) {
+					this->S.push_back(sprev);
+					this->Y.push_back(y);
+					this->rho.push_back(1.0/ys);
+				}
+			}
+
+			//----------Check convergence----------
+			this->iterations = k;
+			this->norm = sqrt(std::inner_product(R.begin(), R.end(), R.begin(), T()))/_normF;
+			if (this->isverbose) {
+				std::cout << "\tk = " << k << "\tNorm = " << this->norm << std::endl;
+			}
+			if (this->norm < this->eps) {
+				return true;
+			}
+			if (k == this->itrmax || !std::isfinite(this->norm)) {
+				break;
+			}
+
+			//----------Get search direction----------
+			std::vector<T> du = this->method == NewtonMethod::BFGS ? this->SolveBFGS(R) : this->SolveTangent(R);
+
+			//----------Update with or without line search----------
+			Rprev = R;
+			hasR = false;
+			if (!this->islinesearch) {
+				_update(du);
+			} else {
+				//  Secant search of s giving du.R(u + s*du) = 0
+				T g0 = std::inner_product(du.begin(), du.end(), R.begin(), T());
+				T s = 1.0;
+				_update(du);
+				_residual(R);
+				T g = std::inner_product(du.begin(), du.end(), R.begin(), T());
+				for (int l = 0; l < this->lsmax && fabs(g) > this->lsratio*fabs(g0); l++) {
+					T snew = fabs(g0 - g) > T() ? s*g0/(g0 - g) : s;
+					snew = std::max((T)0.1, std::min((T)1.0, snew));
+					if (fabs(snew - s) < 1.0e-3) {
+						break;
+					}
+					std::vector<T> dds = du;
+					for (auto& ddsi : dds) {
+						ddsi *= snew - s;
+					}
+					_update(dds);
+					_residual(R);
+					g = std::inner_product(du.begin(), du.end(), R.begin(), T());
+					s = snew;
+				}
+				for (auto& dui : du) {
+					dui *= s;
+				}
+				hasR = true;
+			}
+			sprev = du;
+		}
+
+		return false;
+	}
+
+
+	template<class T>
+	int NewtonRaphson<T>::ITERATIONS() const {
+		return this->iterations;
+	}
+
+
+	template<class T>
+	int NewtonRaphson<T>::REFORMS() const {
+		return this->reforms;
+	}
+
+
+	template<class T>
+	T NewtonRaphson<T>::NORM() const {
+		return this->norm;
+	}
+
+
+	template<class T>
+	std::vector<T> NewtonRaphson<T>::SolveTangent(const std::vector<T>& _R) {
+		return this->issymmetric ? ScalingCG(this->K, this->D, _R, this->solveritrmax, this->solvereps) : ScalingBiCGSTAB(this->K, this->D, _R, this->solveritrmax, this->solvereps);
+	}
+
+
+	template<class T>
+	std::vector<T> NewtonRaphson<T>::SolveBFGS(const std::vector<T>& _R) {
+		//----------Two loop recursion with H0 = K^-1----------
+		std::vector<T> q = _R;
+		std::vector<T> alpha = std::vector<T>(this->S.size());
+		for (int i = (int)this->S.size() - 1; i >= 0; i--) {
+			alpha[i] = this->rho[i]*std::inner_product(this->S[i].begin(), this->S[i].end(), q.begin(), T());
+			xexpay(q, -alpha[i], this->Y[i]);
+		}
+		std::vector<T> r = this->SolveTangent(q);
+		for (int i = 0; i < this->S.size(); i++) {
+			T beta = this->rho[i]*std::inner_product(this->Y[i].begin(), this->Y[i].end(), r.begin(), T());
+			xexpay(r, alpha[i] - beta, this->S[i]);
+		}
+		return r;
+	}
+}
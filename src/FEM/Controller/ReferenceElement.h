@@ -0,0 +1,64 @@
+//*****************************************************************************
+//Title		:PANSFEM2/FEM/Controller/ReferenceElement.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/18
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Models/Matrix.h"
+
+
+namespace PANSFEM2 {
+	//********************Table of shape functions at integration points********************
+	//	Values of N and dNdr are evaluated only once for each pair of shape function SF and integration IC,
+	//	and shared by all element kernels.
+	template<class T, template<class>class SF, template<class>class IC>
+	class ReferenceElement{
+public:
+		static const Vector<T>& N(int _g);			//Shape function values at g-th integration point
+		static const Matrix<T>& dNdr(int _g);		//Shape function derivatives at g-th integration point
+
+
+private:
+		ReferenceElement();
+		static const ReferenceElement<T, SF, IC>& Table();
+
+
+		std::vector<Vector<T> > n;				//Shape function values at all integration points
+		std::vector<Matrix<T> > dndr;			//Shape function derivatives at all integration points
+	};
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	ReferenceElement<T, SF, IC>::ReferenceElement() {
+		this->n.reserve(IC<T>::N);
+		this->dndr.reserve(IC<T>::N);
+		for (int g = 0; g < IC<T>::N; g++) {
+			this->n.push_back(SF<T>::N(IC<T>::Points[g]));
+			this->dndr.push_back(SF<T>::dNdr(IC<T>::Points[g]));
+		}
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	const ReferenceElement<T, SF, IC>& ReferenceElement<T, SF, IC>::Table() {
+		static const ReferenceElement<T, SF, IC> table;		//Initialized at first call after IC<T>::Points
+		return table;
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	const Vector<T>& ReferenceElement<T, SF, IC>::N(int _g) {
+		return Table().n[_g];
+	}
+
+
+	template<class T, template<class>class SF, template<class>class IC>
+	const Matrix<T>& ReferenceElement<T, SF, IC>::dNdr(int _g) {
+		return Table().dndr[_g];
+	}
+}
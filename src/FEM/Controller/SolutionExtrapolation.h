@@ -0,0 +1,176 @@
+//*****************************************************************************
+//Title		:src/FEM/Controller/SolutionExtrapolation.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/19
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <numeric>
+
+
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+#include "../../LinearAlgebra/Solvers/LU.h"
+
+
+namespace PANSFEM2 {
+    //********************Type of extrapolation********************
+    enum class ExtrapolationMethod {
+        PREVIOUS,       //  Last solution
+        LINEAR,         //  Line through last 2 solutions in t
+        QUADRATIC,      //  Parabola through last 3 solutions in t
+        POD             //  Galerkin projection of A*x = b onto span of last solutions
+    };
+
+
+    //********************Initial guess of iterative solvers from previous solutions********************
+    //  Usage :
+    //      1. x0 = Predict(t) or Predict(A, b, t) before solving A*x = b at t
+    //      2. Push(x, t) after solving
+    //  Predictions are empty vectors until first Push, which the solvers take as zero.
+    //  POD works without t, so it is also suitable for optimization loops where A changes.
+    template<class T>
+    class SolutionExtrapolation {
+public:
+        SolutionExtrapolation();
+        SolutionExtrapolation(ExtrapolationMethod _method, int _size = 4);
+
+
+        void Clear();
+        void Push(const std::vector<T>& _x, T _t = T());
+        std::vector<T> Predict(T _t = T()) const;
+        std::vector<T> Predict(CSR<T>& _A, const std::vector<T>& _b, T _t = T()) const;
+
+
+        int SIZE() const;                               //  Number of stored solutions
+
+
+private:
+        ExtrapolationMethod method;
+        int size;                                       //  Maximum number of stored solutions
+        std::vector<std::vector<T> > xs;                //  Stored solutions from old to new
+        std::vector<T> ts;                              //  Time of stored solutions
+    };
+
+
+    template<class T>
+    SolutionExtrapolation<T>::SolutionExtrapolation() : SolutionExtrapolation(ExtrapolationMethod::LINEAR) {}
+
+
+    template<class T>
+    SolutionExtrapolation<T>::SolutionExtrapolation(ExtrapolationMethod _method, int _size) {
+        this->method = _method;
+        switch (_method) {
+            case ExtrapolationMethod::PREVIOUS :	this->size = 1;	break;
+            case ExtrapolationMethod::LINEAR :		this->size = 2;	break;
+            case ExtrapolationMethod::QUADRATIC :	this->size = 3;	break;
+            case ExtrapolationMethod::POD :			this->size = _size;	break;
+        }
+        assert(this->size > 0);
+    }
+
+
+    template<class T>
+    void SolutionExtrapolation<T>::Clear() {
+        this->xs.clear();
+        this->ts.clear();
+    }
+
+
+    template<class T>
+    void SolutionExtrapolation<T>::Push(const std::vector<T>& _x, T _t) {
+        assert(this->xs.empty() || this->xs.back().size() == _x.size());
+        if (this->xs.size() == this->size) {
+            this->xs.erase(this->xs.begin());
+            this->ts.erase(this->ts.begin());
+        }
+        this->xs.push_back(_x);
+        this->ts.push_back(_t);
+    }
+
+
+    template<class T>
+    std::vector<T> SolutionExtrapolation<T>::Predict(T _t) const {
+        if (this->xs.empty()) {
+            return std::vector<T>();
+        }
+
+        //----------Lagrange polynomial through last solutions----------
+        int m = this->method == ExtrapolationMethod::POD ? 1 : this->xs.size();
+        int begin = this->xs.size() - m;
+        std::vector<T> x = std::vector<T>(this->xs.back().size(), T());
+        for (int i = begin; i < this->xs.size(); i++) {
+            T li = 1.0;
+            for (int j = begin; j < this->xs.size(); j++) {
+                if (j != i) {
+                    assert(this->ts[i] != this->ts[j]);
+                    li *= (_t - this->ts[j])/(this->ts[i] - this->ts[j]);
+                }
+            }
+            xexpay(x, li, this->xs[i]);
+        }
+        return x;
+    }
+
+
+    template<class T>
+    std::vector<T> SolutionExtrapolation<T>::Predict(CSR<T>& _A, const std::vector<T>& _b, T _t) const {
+        if (this->method != ExtrapolationMethod::POD || this->xs.empty()) {
+            return this->Predict(_t);
+        }
+
+        //----------Orthonormal basis V of stored solutions with modified Gram-Schmidt----------
+        std::vector<std::vector<T> > V;
+        for (int i = this->xs.size() - 1; i >= 0; i--) {
+            std::vector<T> v = this->xs[i];
+            T norm0 = sqrt(std::inner_product(v.begin(), v.end(), v.begin(), T()));
+            for (auto& Vj : V) {
+                xexpay(v, -std::inner_product(v.begin(), v.end(), Vj.begin(), T()), Vj);
+            }
+            T norm = sqrt(std::inner_product(v.begin(), v.end(), v.begin(), T()));
+            if (norm > 1.0e-8*norm0) {
+                for (auto& vi : v) {
+                    vi /= norm;
+                }
+                V.push_back(v);
+            }
+        }
+        if (V.empty()) {
+            return this->xs.back();
+        }
+
+        //----------Solve (V^T*A*V)*c = V^T*b and x = V*c----------
+        int m = V.size();
+        Matrix<T> G = Matrix<T>(m, m);
+        Vector<T> c = Vector<T>(m);
+        for (int j = 0; j < m; j++) {
+            std::vector<T> AVj = _A*V[j];
+            for (int i = 0; i < m; i++) {
+                G(i, j) = std::inner_product(V[i].begin(), V[i].end(), AVj.begin(), T());
+            }
+            c(j) = std::inner_product(V[j].begin(), V[j].end(), _b.begin(), T());
+        }
+        std::vector<int> pivot = std::vector<int>(m);
+        LU(G, pivot);
+        SolveLU(G, c, pivot);
+
+        std::vector<T> x = std::vector<T>(_b.size(), T());
+        for (int j = 0; j < m; j++) {
+            xexpay(x, c(j), V[j]);
+        }
+        return x;
+    }
+
+
+    template<class T>
+    int SolutionExtrapolation<T>::SIZE() const {
+        return this->xs.size();
+    }
+}
@@ -0,0 +1,616 @@
+//*****************************************************************************
+//Title		:src/FEM/Controller/TimeIntegration.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/18
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+
+#include "../../LinearAlgebra/Models/LILCSR.h"
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+#include "Assembling.h"
+#include "SolutionExtrapolation.h"
+#include "ReferenceElement.h"
+
+
+namespace PANSFEM2 {
+    //********************Theta method for C*du/dt + K*u = F with constant C and K********************
+    //  C and K are assembled only once. A = C/dt + theta*K, B = C/dt - (1 - theta)*K and
+    //  the diagonal scaling of A are made in Initialize(), so that a step is one SpMV and one solve.
+    //  Usage :
+    //      1. Assembling(Ce, Ke, nodetoelement, element) for all elements
+    //      2. Initialize(u, dt)
+    //      3. Step(u, F) for each time step. SetTimeStep(dt) changes time step without re-assembling.
+    //         Before calling, set Dirichlet values of t^(n+1) into u (e.g. SetDirichlet)
+    //         and pass F = theta*F^(n+1) + (1 - theta)*F^n of Neumann conditions.
+    //  Step is Trial followed by Accept. For adaptive time stepping call Trial(u, F) instead,
+    //  which solves u^(n+1) into u without advancing time, and then Accept() to commit it or
+    //  Reject(u) to restore free values of u^n into u before retrying with another time step.
+    //  Initial guess of each solve is Galerkin projection onto last 4 solutions (POD) by default,
+    //  which is changed by SetExtrapolation(method, size).
+    template<class T>
+    class ThetaIntegrator {
+public:
+        ThetaIntegrator();
+        ThetaIntegrator(const std::vector<std::vector<int> >& _nodetoglobal, T _theta, bool _issymmetric = true);
+
+
+        void Assembling(Matrix<T>& _Ce, Matrix<T>& _Ke, const std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element);
+        void Initialize(std::vector<Vector<T> >& _u, T _dt);
+        void Step(std::vector<Vector<T> >& _u, const std::vector<T>& _F, int _itrmax = 100000, T _eps = 1.0e-10);
+        void Trial(std::vector<Vector<T> >& _u, const std::vector<T>& _F, int _itrmax = 100000, T _eps = 1.0e-10);
+        void Accept();
+        void Reject(std::vector<Vector<T> >& _u);
+        void SetTimeStep(T _dt);
+        T GetTimeStep() const;
+        void SetExtrapolation(ExtrapolationMethod _method, int _size = 4);
+
+
+private:
+        std::vector<std::vector<int> > nodetoglobal;    //  Index of free DOF (-1 if fixed)
+        std::vector<std::vector<int> > nodetofixed;     //  Index of fixed DOF (-1 if free)
+        int KDEGREE;                                    //  Number of free DOFs
+        int DDEGREE;                                    //  Number of fixed DOFs
+        T theta;                                        //  Parameter of theta method
+        T dt;                                           //  Time step
+        bool issymmetric;                               //  Use CG if true, otherwise BiCGSTAB
+
+
+        LILCSR<T> Cff, Kff, Cfd, Kfd;                   //  Assembled matrices (free-free and free-fixed)
+        CSR<T> C, K, Cd, Kd;                            //  Compressed assembled matrices
+        CSR<T> A, B, Ad, Bd;                            //  Matrices of theta method
+        std::vector<T> D;                               //  Diagonal of A for scaling
+        std::vector<T> ud;                              //  Fixed values at t^n
+        T t;                                            //  Time from Initialize
+        SolutionExtrapolation<T> extrapolation;         //  Initial guess from previous solutions
+        bool istrial;                                   //  Trial step is waiting for Accept or Reject
+        std::vector<T> uftrial, udtrial;                //  Free and fixed values of trial step at t^(n+1)
+        std::vector<T> ufold;                           //  Free values at t^n to be restored by Reject
+
+
+        std::vector<T> GetFree(std::vector<Vector<T> >& _u);
+        std::vector<T> GetFixed(std::vector<Vector<T> >& _u);
+    };
+
+
+    template<class T>
+    ThetaIntegrator<T>::ThetaIntegrator() {
+        this->KDEGREE = 0;
+        this->DDEGREE = 0;
+        this->theta = 0.5;
+        this->dt = T();
+        this->issymmetric = true;
+        this->t = T();
+        this->extrapolation = SolutionExtrapolation<T>(ExtrapolationMethod::POD, 4);
+        this->istrial = false;
+    }
+
+
+    template<class T>
+    ThetaIntegrator<T>::ThetaIntegrator(const std::vector<std::vector<int> >& _nodetoglobal, T _theta, bool _issymmetric) {
+        this->nodetoglobal = _nodetoglobal;
+        this->nodetofixed = _nodetoglobal;
+        this->KDEGREE = 0;
+        this->DDEGREE = 0;
+        for (int i = 0; i < _nodetoglobal.size(); i++) {
+            for (int j = 0; j < _nodetoglobal[i].size(); j++) {
+                if (_nodetoglobal[i][j] != -1) {
+                    this->KDEGREE = std::max(this->KDEGREE, _nodetoglobal[i][j] + 1);
+                    this->nodetofixed[i][j] = -1;
+                } else {
+                    this->nodetofixed[i][j] = this->DDEGREE;
+                    this->DDEGREE++;
+                }
+            }
+        }
+        this->theta = _theta;
+        this->dt = T();
+        this->issymmetric = _issymmetric;
+        this->t = T();
+        this->extrapolation = SolutionExtrapolation<T>(ExtrapolationMethod::POD, 4);
+        this->istrial = false;
+
+        this->Cff = LILCSR<T>(this->KDEGREE, this->KDEGREE);
+        this->Kff = LILCSR<T>(this->KDEGREE, this->KDEGREE);
+        this->Cfd = LILCSR<T>(this->KDEGREE, this->DDEGREE);
+        this->Kfd = LILCSR<T>(this->KDEGREE, this->DDEGREE);
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::Assembling(Matrix<T>& _Ce, Matrix<T>& _Ke, const std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        for (int i = 0; i < _element.size(); i++) {
+            for (auto doui : _nodetoelement[i]) {
+                int gi = this->nodetoglobal[_element[i]][doui.first];
+                if (gi != -1) {
+                    for (int j = 0; j < _element.size(); j++) {
+                        for (auto douj : _nodetoelement[j]) {
+                            int gj = this->nodetoglobal[_element[j]][douj.first];
+                            //----------Dirichlet condition NOT imposed----------
+                            if (gj != -1) {
+                                this->Cff.set(gi, gj, this->Cff.get(gi, gj) + _Ce(doui.second, douj.second));
+                                this->Kff.set(gi, gj, this->Kff.get(gi, gj) + _Ke(doui.second, douj.second));
+                            }
+                            //----------Dirichlet condition imposed----------
+                            else {
+                                int dj = this->nodetofixed[_element[j]][douj.first];
+                                this->Cfd.set(gi, dj, this->Cfd.get(gi, dj) + _Ce(doui.second, douj.second));
+                                this->Kfd.set(gi, dj, this->Kfd.get(gi, dj) + _Ke(doui.second, douj.second));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::Initialize(std::vector<Vector<T> >& _u, T _dt) {
+        this->C = CSR<T>(this->Cff);
+        this->K = CSR<T>(this->Kff);
+        this->Cd = CSR<T>(this->Cfd);
+        this->Kd = CSR<T>(this->Kfd);
+
+        this->SetTimeStep(_dt);
+        this->ud = this->GetFixed(_u);
+        this->t = T();
+        this->extrapolation.Clear();
+        this->extrapolation.Push(this->GetFree(_u), this->t);
+        this->istrial = false;
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::Step(std::vector<Vector<T> >& _u, const std::vector<T>& _F, int _itrmax, T _eps) {
+        this->Trial(_u, _F, _itrmax, _eps);
+        this->Accept();
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::Trial(std::vector<Vector<T> >& _u, const std::vector<T>& _F, int _itrmax, T _eps) {
+        assert(_F.size() == this->KDEGREE && !this->istrial);
+
+        //----------Make right hand side vector b = B*u^n + Bd*ud^n - Ad*ud^(n+1) + F----------
+        this->ufold = this->GetFree(_u);
+        this->udtrial = this->GetFixed(_u);
+        std::vector<T> b = this->B*this->ufold;
+        std::vector<T> Bdud = this->Bd*this->ud;
+        std::vector<T> Adud = this->Ad*this->udtrial;
+        for (int i = 0; i < this->KDEGREE; i++) {
+            b[i] += Bdud[i] - Adud[i] + _F[i];
+        }
+
+        //----------Solve A*u^(n+1) = b----------
+        std::vector<T> x0 = this->extrapolation.Predict(this->A, b, this->t + this->dt);
+        this->uftrial = this->issymmetric ? ScalingCG(this->A, this->D, b, _itrmax, _eps, x0) : ScalingBiCGSTAB(this->A, this->D, b, _itrmax, _eps, x0);
+        for (int i = 0; i < this->nodetoglobal.size(); i++) {
+            for (int j = 0; j < this->nodetoglobal[i].size(); j++) {
+                if (this->nodetoglobal[i][j] != -1) {
+                    _u[i](j) = this->uftrial[this->nodetoglobal[i][j]];
+                }
+            }
+        }
+
+        this->istrial = true;
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::Accept() {
+        assert(this->istrial);
+
+        this->ud = this->udtrial;
+        this->t += this->dt;
+        this->extrapolation.Push(this->uftrial, this->t);
+        this->istrial = false;
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::Reject(std::vector<Vector<T> >& _u) {
+        assert(this->istrial);
+
+        for (int i = 0; i < this->nodetoglobal.size(); i++) {
+            for (int j = 0; j < this->nodetoglobal[i].size(); j++) {
+                if (this->nodetoglobal[i][j] != -1) {
+                    _u[i](j) = this->ufold[this->nodetoglobal[i][j]];
+                }
+            }
+        }
+        this->istrial = false;
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::SetTimeStep(T _dt) {
+        //----------Re-form A, B and scaling from assembled C and K----------
+        this->dt = _dt;
+        this->A = this->C/this->dt + this->K*this->theta;
+        this->B = this->C/this->dt - this->K*(1.0 - this->theta);
+        this->Ad = this->Cd/this->dt + this->Kd*this->theta;
+        this->Bd = this->Cd/this->dt - this->Kd*(1.0 - this->theta);
+        this->D = GetDiagonal(this->A);
+    }
+
+
+    template<class T>
+    T ThetaIntegrator<T>::GetTimeStep() const {
+        return this->dt;
+    }
+
+
+    template<class T>
+    void ThetaIntegrator<T>::SetExtrapolation(ExtrapolationMethod _method, int _size) {
+        this->extrapolation = SolutionExtrapolation<T>(_method, _size);
+    }
+
+
+    template<class T>
+    std::vector<T> ThetaIntegrator<T>::GetFree(std::vector<Vector<T> >& _u) {
+        std::vector<T> uf = std::vector<T>(this->KDEGREE);
+        for (int i = 0; i < this->nodetoglobal.size(); i++) {
+            for (int j = 0; j < this->nodetoglobal[i].size(); j++) {
+                if (this->nodetoglobal[i][j] != -1) {
+                    uf[this->nodetoglobal[i][j]] = _u[i](j);
+                }
+            }
+        }
+        return uf;
+    }
+
+
+    template<class T>
+    std::vector<T> ThetaIntegrator<T>::GetFixed(std::vector<Vector<T> >& _u) {
+        std::vector<T> ud = std::vector<T>(this->DDEGREE);
+        for (int i = 0; i < this->nodetofixed.size(); i++) {
+            for (int j = 0; j < this->nodetofixed[i].size(); j++) {
+                if (this->nodetofixed[i][j] != -1) {
+                    ud[this->nodetofixed[i][j]] = _u[i](j);
+                }
+            }
+        }
+        return ud;
+    }
+
+
+    //********************Explicit method for M*d2u/dt2 = R or M*du/dt = R with lumped M********************
+    //  M is kept as a vector of lumped (row-summed) masses, and no global matrix is made.
+    //  R = F - Fint is assembled element by element, e.g. with AssemblingParallel().
+    //  Usage of central difference :
+    //      1. Assembling(Me, nodetoelement, element) for all elements
+    //      2. Initialize(u, v, R) with R at t^0
+    //      3. CentralDifference(u, R) for each time step with R at t^n
+    //  Usage of forward Euler :
+    //      1. Assembling(Me, nodetoelement, element) for all elements
+    //      2. ForwardEuler(unext, u, R) for each time step with R at t^n
+    template<class T>
+    class ExplicitIntegrator {
+public:
+        ExplicitIntegrator();
+        ExplicitIntegrator(const std::vector<std::vector<int> >& _nodetoglobal, T _dt);
+
+
+        void Assembling(Matrix<T>& _Me, const std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element);
+        void Initialize(std::vector<Vector<T> >& _u, std::vector<Vector<T> >& _v, const std::vector<T>& _R);
+        void CentralDifference(std::vector<Vector<T> >& _u, const std::vector<T>& _R);
+        void ForwardEuler(std::vector<Vector<T> >& _unext, std::vector<Vector<T> >& _u, const std::vector<T>& _R);
+        const std::vector<T>& GetLumpedMass() const;
+        T GetTimeStep() const;
+
+
+private:
+        std::vector<std::vector<int> > nodetoglobal;    //  Index of free DOF (-1 if fixed)
+        int KDEGREE;                                    //  Number of free DOFs
+        T dt;                                           //  Time step
+        std::vector<T> M;                               //  Lumped mass
+        std::vector<T> uprev;                           //  Free values at t^(n-1)
+    };
+
+
+    template<class T>
+    ExplicitIntegrator<T>::ExplicitIntegrator() {
+        this->KDEGREE = 0;
+        this->dt = T();
+    }
+
+
+    template<class T>
+    ExplicitIntegrator<T>::ExplicitIntegrator(const std::vector<std::vector<int> >& _nodetoglobal, T _dt) {
+        this->nodetoglobal = _nodetoglobal;
+        this->KDEGREE = 0;
+        for (auto& node : _nodetoglobal) {
+            for (auto dou : node) {
+                this->KDEGREE = std::max(this->KDEGREE, dou + 1);
+            }
+        }
+        this->dt = _dt;
+        this->M = std::vector<T>(this->KDEGREE, T());
+    }
+
+
+    template<class T>
+    void ExplicitIntegrator<T>::Assembling(Matrix<T>& _Me, const std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element) {
+        AssemblingLumped(this->M, _Me, this->nodetoglobal, _nodetoelement, _element);
+    }
+
+
+    template<class T>
+    void ExplicitIntegrator<T>::Initialize(std::vector<Vector<T> >& _u, std::vector<Vector<T> >& _v, const std::vector<T>& _R) {
+        assert(_R.size() == this->KDEGREE);
+
+        //----------u^(-1) = u^0 - dt*v^0 + 0.5*dt^2*a^0----------
+        this->uprev = std::vector<T>(this->KDEGREE);
+        for (int i = 0; i < this->nodetoglobal.size(); i++) {
+            for (int j = 0; j < this->nodetoglobal[i].size(); j++) {
+                int k = this->nodetoglobal[i][j];
+                if (k != -1) {
+                    this->uprev[k] = _u[i](j) - this->dt*_v[i](j) + 0.5*this->dt*this->dt*_R[k]/this->M[k];
+                }
+            }
+        }
+    }
+
+
+    template<class T>
+    void ExplicitIntegrator<T>::CentralDifference(std::vector<Vector<T> >& _u, const std::vector<T>& _R) {
+        assert(_R.size() == this->KDEGREE && this->uprev.size() == this->KDEGREE);
+
+        //----------u^(n+1) = 2*u^n - u^(n-1) + dt^2*M^(-1)*R^n----------
+        for (int i = 0; i < this->nodetoglobal.size(); i++) {
+            for (int j = 0; j < this->nodetoglobal[i].size(); j++) {
+                int k = this->nodetoglobal[i][j];
+                if (k != -1) {
+                    T unow = _u[i](j);
+                    _u[i](j) = 2.0*unow - this->uprev[k] + this->dt*this->dt*_R[k]/this->M[k];
+                    this->uprev[k] = unow;
+                }
+            }
+        }
+    }
+
+
+    template<class T>
+    void ExplicitIntegrator<T>::ForwardEuler(std::vector<Vector<T> >& _unext, std::vector<Vector<T> >& _u, const std::vector<T>& _R) {
+        assert(_R.size() == this->KDEGREE);
+
+        //----------u^(n+1) = u^n + dt*M^(-1)*R^n----------
+        for (int i = 0; i < this->nodetoglobal.size(); i++) {
+            for (int j = 0; j < this->nodetoglobal[i].size(); j++) {
+                int k = this->nodetoglobal[i][j];
+                if (k != -1) {
+                    _unext[i](j) = _u[i](j) + this->dt*_R[k]/this->M[k];
+                }
+            }
+        }
+    }
+
+
+    template<class T>
+    const std::vector<T>& ExplicitIntegrator<T>::GetLumpedMass() const {
+        return this->M;
+    }
+
+
+    template<class T>
+    T ExplicitIntegrator<T>::GetTimeStep() const {
+        return this->dt;
+    }
+
+
+    //********************Adaptive time step controller for theta method********************
+    //  Local error is estimated with Milne's device : u^P is extrapolated from previous steps
+    //  (quadratic for Crank-Nicolson, linear otherwise) and compared with u^C of theta method.
+    //  Since both errors are proportional to the same derivative of u, 
+    //  d = cC/(cC - cP)*(u^C - u^P), where cC and cP are error constants of corrector and predictor.
+    //  Next time step is chosen by PI controller on e = |d|/(tol*max(|u|, 1)).
+    //  Usage :
+    //      1. LimitTimeStep(dtcfl) if needed, and solve u^(n+1) with GetTimeStep()
+    //      2. If Check(u^(n+1), u^n) is true, step is accepted. Otherwise solve again with reduced GetTimeStep().
+    //         With ThetaIntegrator, solve by Trial and then call Accept() or Reject(u) accordingly.
+    template<class T>
+    class TimeStepController {
+public:
+        TimeStepController();
+        TimeStepController(T _dt, T _dtmin, T _dtmax, T _tolerance, T _theta = 0.5);
+
+
+        T GetTimeStep() const;
+        void LimitTimeStep(T _dtlimit);
+        bool Check(std::vector<Vector<T> >& _unext, std::vector<Vector<T> >& _u);
+        int ACCEPTED() const;
+        int REJECTED() const;
+
+
+private:
+        T dt, dtold, dtoldold;                          //  Time steps of t^n->t^(n+1), t^(n-1)->t^n and t^(n-2)->t^(n-1)
+        T dtmin, dtmax;                                 //  Bounds of time step
+        T tolerance;                                    //  Relative tolerance of local error
+        T theta;                                        //  Parameter of theta method
+        int order;                                      //  Order of theta method
+        T eold;                                         //  Previous error norm
+        int accepted, rejected;                         //  Number of accepted and rejected steps
+        std::vector<Vector<T> > uold, uoldold;          //  Values at t^(n-1) and t^(n-2)
+    };
+
+
+    template<class T>
+    TimeStepController<T>::TimeStepController() {
+        this->dt = T();
+        this->dtold = T();
+        this->dtoldold = T();
+        this->dtmin = T();
+        this->dtmax = T();
+        this->tolerance = T();
+        this->theta = 0.5;
+        this->order = 2;
+        this->eold = 1.0;
+        this->accepted = 0;
+        this->rejected = 0;
+    }
+
+
+    template<class T>
+    TimeStepController<T>::TimeStepController(T _dt, T _dtmin, T _dtmax, T _tolerance, T _theta) {
+        assert(0.0 < _dtmin && _dtmin <= _dt && _dt <= _dtmax && 0.0 < _theta);
+        this->dt = _dt;
+        this->dtold = _dt;
+        this->dtoldold = _dt;
+        this->dtmin = _dtmin;
+        this->dtmax = _dtmax;
+        this->tolerance = _tolerance;
+        this->theta = _theta;
+        this->order = fabs(_theta - 0.5) < 1.0e-10 ? 2 : 1;
+        this->eold = 1.0;
+        this->accepted = 0;
+        this->rejected = 0;
+    }
+
+
+    template<class T>
+    T TimeStepController<T>::GetTimeStep() const {
+        return this->dt;
+    }
+
+
+    template<class T>
+    void TimeStepController<T>::LimitTimeStep(T _dtlimit) {
+        this->dt = std::max(this->dtmin, std::min(this->dt, _dtlimit));
+    }
+
+
+    template<class T>
+    bool TimeStepController<T>::Check(std::vector<Vector<T> >& _unext, std::vector<Vector<T> >& _u) {
+        assert(_unext.size() == _u.size());
+
+        const T kI = 0.3/(this->order + 1.0);  //  Integral gain
+        const T kP = 0.4/(this->order + 1.0);  //  Proportional gain
+        const T safety = 0.9;                   //  Safety factor
+        const T growmax = 2.0;                  //  Maximum ratio of dt^(n+1)/dt^n
+        const T shrinkmin = 0.2;                //  Minimum ratio of dt^(n+1)/dt^n
+
+        //----------Start up without error estimation----------
+        if (this->accepted < this->order) {
+            this->uoldold = this->uold;
+            this->uold = _u;
+            this->dtoldold = this->dtold;
+            this->dtold = this->dt;
+            this->accepted++;
+            return true;
+        }
+
+        //----------Get extrapolation weights of u^P and error constants----------
+        T h0 = this->dt, h1 = this->dtold, h2 = this->dtoldold;
+        T w0, w1, w2, cC, cP;
+        if (this->order == 2) {
+            //  Quadratic through t^(n-2), t^(n-1), t^n, u''' terms
+            w0 = (h0 + h1)*(h0 + h1 + h2)/(h1*(h1 + h2));
+            w1 = -h0*(h0 + h1 + h2)/(h1*h2);
+            w2 = h0*(h0 + h1)/(h2*(h1 + h2));
+            cC = -h0*h0*h0/12.0;
+            cP = h0*(h0 + h1)*(h0 + h1 + h2)/6.0;
+        } else {
+            //  Linear through t^(n-1), t^n, u'' terms
+            w0 = (h0 + h1)/h1;
+            w1 = -h0/h1;
+            w2 = T();
+            cC = (0.5 - this->theta)*h0*h0;
+            cP = 0.5*h0*(h0 + h1);
+        }
+
+        //----------Estimate local error----------
+        T dnorm = T(), unorm = T();
+        for (int i = 0; i < _u.size(); i++) {
+            Vector<T> up = _u[i]*w0 + this->uold[i]*w1;
+            if (this->order == 2) {
+                up += this->uoldold[i]*w2;
+            }
+            Vector<T> d = (_unext[i] - up)*(cC/(cC - cP));
+            dnorm += d*d;
+            unorm += _unext[i]*_unext[i];
+        }
+        T e = std::max(sqrt(dnorm)/(this->tolerance*std::max(sqrt(unorm), (T)1.0)), (T)1.0e-10);
+
+        //----------Reject and shrink time step----------
+        if (e > 1.0 && this->dt > this->dtmin) {
+            this->dt = std::max(this->dtmin, this->dt*std::max(shrinkmin, safety*pow(e, -1.0/(this->order + 1.0))));
+            this->rejected++;
+            return false;
+        }
+
+        //----------Accept and choose next time step by PI controller----------
+        this->uoldold = this->uold;
+        this->uold = _u;
+        this->dtoldold = this->dtold;
+        this->dtold = this->dt;
+        T ratio = safety*pow(e, -kI)*pow(this->eold/e, kP);
+        this->dt = std::max(this->dtmin, std::min(this->dtmax, this->dt*std::max(shrinkmin, std::min(growmax, ratio))));
+        this->eold = e;
+        this->accepted++;
+        return true;
+    }
+
+
+    template<class T>
+    int TimeStepController<T>::ACCEPTED() const {
+        return this->accepted;
+    }
+
+
+    template<class T>
+    int TimeStepController<T>::REJECTED() const {
+        return this->rejected;
+    }
+
+
+    //********************Get time step of given Courant number from element size he********************
+    //  he = 2*|u|/sum|u.dN/dX| is the same element size as used in SUPG tau.
+    template<class T, template<class>class SF, template<class>class IC>
+    T GetCFLTimeStep(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements, std::vector<Vector<T> >& _u, T _courant) {
+        T dtcfl = std::numeric_limits<T>::max();
+
+#pragma omp parallel for reduction(min:dtcfl)
+        for (int id = 0; id < _elements.size(); id++) {
+            int m = _elements[id].size();
+            Matrix<T> X = Matrix<T>(m, SF<T>::d);
+            Matrix<T> u = Matrix<T>(m, SF<T>::d);
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < SF<T>::d; j++) {
+                    X(i, j) = _x[_elements[id][i]](j);
+                    u(i, j) = _u[_elements[id][i]](j);
+                }
+            }
+
+            for (int g = 0; g < IC<T>::N; g++) {
+                const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+                const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+                Matrix<T> dNdX = (dNdr*X).Inverse()*dNdr;
+                Vector<T> U = u.Transpose()*N;
+                Vector<T> dNdXU = dNdX.Transpose()*U;
+
+                //----------dt = C*he/|u| = 2*C/sum|u.dN/dX|----------
+                T sum = T();
+                for (int i = 0; i < m; i++) {
+                    sum += fabs(dNdXU(i));
+                }
+                if (sum > 1.0e-10) {
+                    dtcfl = std::min(dtcfl, 2.0*_courant/sum);
+                }
+            }
+        }
+
+        return dtcfl;
+    }
+}
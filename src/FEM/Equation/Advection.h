@@ -12,6 +12,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -32,8 +33,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -64,7 +65,7 @@ namespace PANSFEM2 {
 		Vector<T> a = Vector<T>({ _ax, _ay });
 		
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -107,7 +108,7 @@ namespace PANSFEM2 {
 		Vector<T> a = Vector<T>({ _ax, _ay });
 		
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -148,7 +149,7 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -175,8 +176,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 
@@ -204,8 +205,8 @@ namespace PANSFEM2 {
 		Vector<T> a = Vector<T>({ _ax, _ay });
 		
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -52,8 +53,8 @@ namespace PANSFEM2 {
 
         for(int g = 0; g < IC0<T>::N; g++){
             for(int h = 0; h < IC12<T>::N; h++){
-                Vector<T> N = SF<T>::N(IC0<T>::Points[g]);
-                Matrix<T> dNdr = SF<T>::dNdr(IC0<T>::Points[g]);
+                const Vector<T>& N = ReferenceElement<T, SF, IC0>::N(g);
+                const Matrix<T>& dNdr = ReferenceElement<T, SF, IC0>::dNdr(g);
                 
                 Vector<T> itazeta = IC12<T>::Points[h];
                 Matrix<T> J = (dNdr*(X + 0.5*_a*itazeta(0)*v1 + 0.5*_b*itazeta(1)*v2)).Vstack((0.5*_a*N.Transpose()*v1).Vstack(0.5*_b*N.Transpose()*v2));
@@ -82,7 +83,7 @@ namespace PANSFEM2 {
                 P(2, 0) = 2.0*P0(0)*P2(0);  P(2, 1) = 2.0*P0(1)*P2(1);  P(2, 2) = 2.0*P0(2)*P2(2);  P(2, 3) = P0(0)*P2(1) + P0(1)*P2(0);    P(2, 4) = P0(0)*P2(2) + P0(2)*P2(0);    P(2, 5) = P0(1)*P2(2) + P0(2)*P2(1);
                 Matrix<T> D = P.Transpose()*D0*P;
 
-                _Ke += B.Transpose()*D*B*detJ*IC0<T>::Weights[g][0]*IC12<T>::Weights[h][0]*IC12<T>::Weights[h][1];
+                AddBtDB(_Ke, B, D, detJ*IC0<T>::Weights[g][0]*IC12<T>::Weights[h][0]*IC12<T>::Weights[h][1]);
             }
         } 
     }
@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -30,7 +31,7 @@ namespace PANSFEM2 {
         //----------Loop of Gauss Integration----------
         for (int g = 0; g < IC<T>::N; g++) {
 			//----------Get shape function and difference of shape function----------
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 
 			//----------Get difference of shape function----------
 			Matrix<T> dXdr = dNdr*X;
@@ -55,7 +56,7 @@ namespace PANSFEM2 {
         //----------Loop of Gauss Integration----------
         for (int g = 0; g < IC<T>::N; g++) {
 			//----------Get shape function and difference of shape function----------
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 
 			//----------Get difference of shape function----------
 			Matrix<T> dXdr = dNdr*X;
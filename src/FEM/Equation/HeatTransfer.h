@@ -8,10 +8,14 @@
 
 #pragma once
 #include <vector>
+#include <cassert>
+#include <algorithm>
 
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
+#include "../Controller/ElementGeometryCache.h"
 
 
 namespace PANSFEM2 {
@@ -33,7 +37,7 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> B = dXdr.Inverse()*dNdr;
@@ -43,6 +47,91 @@ namespace PANSFEM2 {
 	}
 
 
+	//******************************Heat transfer matrices of elements in [_begin, _end) at once******************************
+	//	Elements are evaluated in batches of W with structure-of-arrays layout [value][lane], 
+	//	so that the loops over lanes (= elements) are vectorized.
+	template<class T, template<class>class SF, template<class>class IC>
+	void HeatTransferBatch(std::vector<Matrix<T> >& _Kes, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<std::vector<int> >& _elements, int _begin, int _end, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, T _alpha, T _t) {
+		assert(_doulist.size() == 1 && SF<T>::d == 2);
+		assert(0 <= _begin && _begin <= _end && _end <= _elements.size());
+
+		const int W = 8;				//	Number of lanes
+		const int n = SF<T>::n;			//	Number of nodes
+
+		_Kes = std::vector<Matrix<T> >(_end - _begin);
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(n, std::vector<std::pair<int, int> >(1));
+		for(int i = 0; i < n; i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], i);
+		}
+
+		std::vector<T> X = std::vector<T>(2*n*W);		//	Nodal coordinates [2*i + k][lane]
+		std::vector<T> dNdX = std::vector<T>(2*n*W);	//	Derivatives of shape functions [2*i + k][lane]
+		std::vector<T> Ke = std::vector<T>(n*n*W);		//	Element matrices [i*n + j][lane]
+		T w[W];
+
+		for(int head = _begin; head < _end; head += W) {
+			int nw = std::min(W, _end - head);
+			std::fill(Ke.begin(), Ke.end(), T());
+			for(int l = 0; l < W; l++) {
+				const std::vector<int>& element = _elements[l < nw ? head + l : head];
+				assert(element.size() == n);
+				for(int i = 0; i < n; i++) {
+					X[(2*i)*W + l] = _x[element[i]](0);
+					X[(2*i + 1)*W + l] = _x[element[i]](1);
+				}
+			}
+
+			for(int g = 0; g < IC<T>::N; g++) {
+				T dNdr[2][n];
+				for(int i = 0; i < n; i++) {
+					dNdr[0][i] = ReferenceElement<T, SF, IC>::dNdr(g)(0, i);
+					dNdr[1][i] = ReferenceElement<T, SF, IC>::dNdr(g)(1, i);
+				}
+				T wg = _alpha*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+
+#pragma omp simd
+				for(int l = 0; l < W; l++) {
+					T J00 = T(), J01 = T(), J10 = T(), J11 = T();
+					for(int i = 0; i < n; i++) {
+						J00 += dNdr[0][i]*X[(2*i)*W + l];	J01 += dNdr[0][i]*X[(2*i + 1)*W + l];
+						J10 += dNdr[1][i]*X[(2*i)*W + l];	J11 += dNdr[1][i]*X[(2*i + 1)*W + l];
+					}
+					T J = J00*J11 - J01*J10;
+					for(int i = 0; i < n; i++) {
+						dNdX[(2*i)*W + l] = (J11*dNdr[0][i] - J01*dNdr[1][i])/J;
+						dNdX[(2*i + 1)*W + l] = (- J10*dNdr[0][i] + J00*dNdr[1][i])/J;
+					}
+					w[l] = J*wg;
+				}
+
+				for(int i = 0; i < n; i++) {
+					for(int j = 0; j < n; j++) {
+						T* Kij = &Ke[(i*n + j)*W];
+						const T* dNidX = &dNdX[(2*i)*W];
+						const T* dNidY = &dNdX[(2*i + 1)*W];
+						const T* dNjdX = &dNdX[(2*j)*W];
+						const T* dNjdY = &dNdX[(2*j + 1)*W];
+#pragma omp simd
+						for(int l = 0; l < W; l++) {
+							Kij[l] += w[l]*(dNidX[l]*dNjdX[l] + dNidY[l]*dNjdY[l]);
+						}
+					}
+				}
+			}
+
+			for(int l = 0; l < nw; l++) {
+				Matrix<T>& Kel = _Kes[head - _begin + l];
+				Kel = Matrix<T>(n, n);
+				for(int i = 0; i < n; i++) {
+					for(int j = 0; j < n; j++) {
+						Kel(i, j) = Ke[(i*n + j)*W + l];
+					}
+				}
+			}
+		}
+	}
+
+
 	//******************************Heat capacity matrix******************************
 	template<class T, template<class>class SF, template<class>class IC>
 	void HeatCapacity(Matrix<T>& _Ce, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, T _rho, T _c, T _t) {
@@ -61,8 +150,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 
@@ -71,6 +160,44 @@ namespace PANSFEM2 {
 	}
 
 
+	//******************************Heat transfer matrix with geometry cache******************************
+	template<class T, template<class>class SF, template<class>class IC>
+	void HeatTransfer(Matrix<T>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, const ElementGeometryCache<T, SF, IC>& _cache, int _id, T _alpha, T _t) {
+		assert(_doulist.size() == 1);
+
+		_Ke = Matrix<T>(_element.size(), _element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(1));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], i);
+		}
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& B = _cache.dNdX(_id, g);
+
+			_Ke += AtB(B, B)*_cache.JW(_id, g)*_alpha*_t;
+		}
+	}
+
+
+	//******************************Heat capacity matrix with geometry cache******************************
+	template<class T, template<class>class SF, template<class>class IC>
+	void HeatCapacity(Matrix<T>& _Ce, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, const ElementGeometryCache<T, SF, IC>& _cache, int _id, T _rho, T _c, T _t) {
+		assert(_doulist.size() == 1);
+
+		_Ce = Matrix<T>(_element.size(), _element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(1));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], i);
+		}
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+
+			_Ce += N*N.Transpose()*_cache.JW(_id, g)*_rho*_c*_t;
+		}
+	}
+
+
 	//******************************Make surface flux vector******************************
 	template<class T, template<class>class SF, template<class>class IC, class F>
 	void HeatTransferSurfaceFlux(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, F _f, T _t){
@@ -89,8 +216,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			Matrix<T> N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Vector<T> x = X.Transpose()*N;
 			Matrix<T> dXdr = dNdr*X;
 			T dl = sqrt((dXdr*dXdr.Transpose())(0, 0));
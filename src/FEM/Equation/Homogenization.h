@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -40,7 +41,7 @@ namespace PANSFEM2 {
 		D *= _E/((1.0 - 2.0*_V)*(1.0 + _V));
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -82,7 +83,7 @@ namespace PANSFEM2 {
 		Matrix<T> I = Identity<T>(3);
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -118,7 +119,7 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -156,7 +157,7 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -168,7 +169,7 @@ namespace PANSFEM2 {
 				B(2, 2 * n) = dNdX(1, n);	B(2, 2 * n + 1) = dNdX(0, n);	
 			}
 
-			_Ke += B.Transpose()*_D*B*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, B, _D, J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 		}
 	}
 
@@ -193,7 +194,7 @@ namespace PANSFEM2 {
 
 		//----------Integraion volume strain term----------
 		for (int g = 0; g < ICV<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(ICV<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, ICV>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -205,12 +206,12 @@ namespace PANSFEM2 {
 				Bvol(2, 2*n) = T();				Bvol(2, 2*n + 1) = T();	
 			}
 
-			_Ke += Bvol.Transpose()*_D*Bvol*J*_t*ICV<T>::Weights[g][0]*ICV<T>::Weights[g][1];
+			AddBtDB(_Ke, Bvol, _D, J*_t*ICV<T>::Weights[g][0]*ICV<T>::Weights[g][1]);
 		}
 
 		//----------Integraion deviation strain term----------
 		for (int g = 0; g < ICD<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(ICD<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, ICD>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -222,7 +223,7 @@ namespace PANSFEM2 {
 				Bdev(2, 2*n) = dNdX(1, n);		Bdev(2, 2*n + 1) = dNdX(0, n);	
 			}
 
-			_Ke += Bdev.Transpose()*_D*Bdev*J*_t*ICD<T>::Weights[g][0]*ICD<T>::Weights[g][1];
+			AddBtDB(_Ke, Bdev, _D, J*_t*ICD<T>::Weights[g][0]*ICD<T>::Weights[g][1]);
 		}
 	}
 
@@ -248,7 +249,7 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -271,8 +272,8 @@ namespace PANSFEM2 {
 			G(1, 0) = T();			G(1, 1) = dPdX(1, 0);	G(1, 2) = T();			G(1, 3) = dPdX(1, 1);
 			G(2, 0) = dPdX(1, 0);	G(2, 1) = dPdX(0, 0);	G(2, 2) = dPdX(1, 1);	G(2, 3) = dPdX(0, 1);
 
-			_Ke += B.Transpose()*_D*B*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
-			Keaa += G.Transpose()*_D*G*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, B, _D, J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
+			AddBtDB(Keaa, G, _D, J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 			Kead += G.Transpose()*_D*B*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
 		}
 
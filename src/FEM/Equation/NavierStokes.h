@@ -13,6 +13,8 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
+#include "../Controller/ElementGeometryCache.h"
 
 
 namespace PANSFEM2 {
@@ -62,14 +64,14 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
 
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
 			Vector<T> U = u.Transpose()*M;
@@ -108,6 +110,67 @@ namespace PANSFEM2 {
 	}
 
 
+	//******************************Get element residual vector for Navier-Stokes equation******************************
+	//	Same as _Fe of NavierStokesTangent without making _Ke.
+	template<class T, template<class>class SFU, template<class>class SFP, template<class>class IC>
+	void NavierStokesResidual(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementu, const std::vector<int>& _elementu, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementp, const std::vector<int>& _elementp, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _up, T _rho, T _mu) {
+		assert(_doulist.size() == 3);
+
+		int m = _elementu.size();   //  Number of shapefunction for velosity u
+        int n = _elementp.size();   //  Number of shapefunction for pressure p
+
+		_Fe = Vector<T>(2*m + n);
+		_nodetoelementu = std::vector<std::vector<std::pair<int, int> > >(m, std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < m; i++) {
+			_nodetoelementu[i][0] = std::make_pair(_doulist[0], i);
+			_nodetoelementu[i][1] = std::make_pair(_doulist[1], m + i);
+		}
+        _nodetoelementp = std::vector<std::vector<std::pair<int, int> > >(n, std::vector<std::pair<int, int> >(1));
+		for(int i = 0; i < n; i++) {
+			_nodetoelementp[i][0] = std::make_pair(_doulist[2], 2*m + i);
+		}
+
+        Matrix<T> Xp = Matrix<T>(n, 2);
+		for(int i = 0; i < n; i++){
+			Xp(i, 0) = _x[_elementp[i]](0); Xp(i, 1) = _x[_elementp[i]](1);
+		}
+
+		Matrix<T> u = Matrix<T>(m, 2);
+		for(int i = 0; i < m; i++){
+			u(i, 0) = _up[_elementu[i]](0); u(i, 1) = _up[_elementu[i]](1);
+		}
+
+		Vector<T> p = Vector<T>(n);
+		for(int i = 0; i < n; i++){
+			p(i) = _up[_elementp[i]](2);
+		}
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
+			Matrix<T> dXdr = dNdr*Xp;
+			T J = dXdr.Determinant();
+
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
+			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
+
+			Vector<T> U = u.Transpose()*M;
+			Matrix<T> dUdX = dMdX*u;
+			T P = p*N;
+			T w = J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+
+            for(int i = 0; i < m; i++){
+				_Fe(i)     -= (_rho*M(i)*U(0)*dUdX(0, 0) + _rho*M(i)*U(1)*dUdX(1, 0) + 2.0*_mu*dMdX(0, i)*dUdX(0, 0) + _mu*dMdX(1, i)*dUdX(1, 0) + _mu*dMdX(1, i)*dUdX(0, 1) - dMdX(0, i)*P)*w;
+				_Fe(i + m) -= (_rho*M(i)*U(0)*dUdX(0, 1) + _rho*M(i)*U(1)*dUdX(1, 1) + _mu*dMdX(0, i)*dUdX(1, 0) + _mu*dMdX(0, i)*dUdX(0, 1) + 2.0*_mu*dMdX(1, i)*dUdX(1, 1) - dMdX(1, i)*P)*w;
+            }
+            for(int i = 0; i < n; i++){
+                _Fe(i + 2*m) -= (N(i)*dUdX(0, 0) + N(i)*dUdX(1, 1))*w;
+            }
+		}
+	}
+
+
 	//******************************Get element stiffness matrix for Navier-Stokes equation******************************
 	template<class T, template<class>class SFU, template<class>class SFP, template<class>class IC>
 	void NavierStokesStiffness(Matrix<T>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementu, const std::vector<int>& _elementu, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementp, const std::vector<int>& _elementp, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _ubar, T _rho, T _mu) {
@@ -138,12 +201,12 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 		
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
 			Vector<T> Ubar = ubar.Transpose()*M;		//	Advection velocity
@@ -162,6 +225,51 @@ namespace PANSFEM2 {
 	}
 
 
+	//******************************Get element stiffness matrix for Navier-Stokes equation with geometry cache******************************
+	template<class T, template<class>class SFU, template<class>class SFP, template<class>class IC>
+	void NavierStokesStiffness(Matrix<T>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementu, const std::vector<int>& _elementu, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementp, const std::vector<int>& _elementp, const std::vector<int>& _doulist, const ElementGeometryCache<T, SFP, IC>& _cache, int _id, std::vector<Vector<T> >& _ubar, T _rho, T _mu) {
+		assert(_doulist.size() == 3);
+
+		int m = _elementu.size();   //  Number of shapefunction for velosity u
+        int n = _elementp.size();   //  Number of shapefunction for pressure p
+
+		_Ke = Matrix<T>(2*m + n, 2*m + n);
+		_nodetoelementu = std::vector<std::vector<std::pair<int, int> > >(m, std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < m; i++) {
+			_nodetoelementu[i][0] = std::make_pair(_doulist[0], i);
+			_nodetoelementu[i][1] = std::make_pair(_doulist[1], m + i);
+		}
+        _nodetoelementp = std::vector<std::vector<std::pair<int, int> > >(n, std::vector<std::pair<int, int> >(1));
+		for(int i = 0; i < n; i++) {
+			_nodetoelementp[i][0] = std::make_pair(_doulist[2], 2*m + i);
+		}
+
+		Matrix<T> ubar = Matrix<T>(m, 2);
+		for(int i = 0; i < m; i++){
+			ubar(i, 0) = _ubar[_elementu[i]](0); ubar(i, 1) = _ubar[_elementu[i]](1);
+		}
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
+			Matrix<T> dMdX = _cache.drdX(_id, g)*dMdr;
+
+			Vector<T> Ubar = ubar.Transpose()*M;		//	Advection velocity
+
+            Matrix<T> K = Matrix<T>(2*m + n, 2*m + n);
+            for(int i = 0; i < m; i++){
+                for(int j = 0; j < m; j++){
+                    K(i, j) = _rho*(M(i)*dMdX(0, j)*Ubar(0) + M(i)*dMdX(1, j)*Ubar(1)) + _mu*(2.0*dMdX(0, i)*dMdX(0, j) + dMdX(1, i)*dMdX(1, j));
+					K(i, j + m) = _mu*dMdX(1, i)*dMdX(0, j);
+					K(i + m, j) = _mu*dMdX(0, i)*dMdX(1, j);														
+					K(i + m, j + m) = _rho*(M(i)*dMdX(1, j)*Ubar(1) + M(i)*dMdX(0, j)*Ubar(0)) + _mu*(dMdX(0, i)*dMdX(0, j) + 2.0*dMdX(1, i)*dMdX(1, j));	
+                }
+            }
+			_Ke += K*_cache.JW(_id, g);
+		}
+	}
+
+
 	//******************************Get element consistent mass matrix for Navier-Stokes equation******************************
 	template<class T, template<class>class SFU, template<class>class SFP, template<class>class IC>
 	void NavierStokesConsistentMass(Matrix<T>& _Me, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementu, const std::vector<int>& _elementu, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementp, const std::vector<int>& _elementp, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, T _rho) {
@@ -187,11 +295,11 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
 
             Matrix<T> Me = Matrix<T>(2*m + n, 2*m + n);
             for(int i = 0; i < m; i++){
@@ -230,12 +338,12 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
             Matrix<T> C = Matrix<T>(2*m + n, 2*m + n);
@@ -283,20 +391,20 @@ namespace PANSFEM2 {
 
 		T area = T();
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			area += J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
 		
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
 			Vector<T> Ubar = ubar.Transpose()*M;		//	Advection velocity
@@ -361,20 +469,20 @@ namespace PANSFEM2 {
 
 		T area = T();
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			area += J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
 
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
 			Vector<T> Ubar = ubar.Transpose()*M;		//	Advection velocity
@@ -439,21 +547,20 @@ namespace PANSFEM2 {
 
 		T area = T();
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			area += J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
 
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
 			Vector<T> Ubar = ubar.Transpose()*M;		//	Advection velocity
@@ -511,11 +618,11 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
 			Vector<T> x = Xp.Transpose()*N;
 			Vector<T> b = _f(x);
 
@@ -554,8 +661,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -593,7 +700,7 @@ namespace PANSFEM2 {
 
 		T Area = T();
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();            
 			Area += J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
@@ -631,8 +738,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -675,8 +782,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -730,8 +837,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -794,14 +901,14 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xq;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
 
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
 			Vector<T> U = u.Transpose()*M;
@@ -855,10 +962,10 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
 
             Matrix<T> K = Matrix<T>(2*m + n, 2*m + n);
             for(int i = 0; i < m; i++) {
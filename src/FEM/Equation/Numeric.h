@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -28,8 +29,8 @@ namespace PANSFEM2 {
 
         for(int g = 0; g < IC<T>::N; g++){
             //----------Get shapefunction----------
-            Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-            Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+            const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+            const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 
 			//----------Get x and f----------
 			Vector<T> x = X.Transpose()*N;
@@ -9,10 +9,13 @@
 #pragma once
 #include <vector>
 #include <cassert>
+#include <algorithm>
 
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
+#include "../Controller/ElementGeometryCache.h"
 
 
 namespace PANSFEM2 {
@@ -41,7 +44,7 @@ namespace PANSFEM2 {
 		D *= _E / ((1.0 - 2.0*_V)*(1.0 + _V));
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -53,7 +56,137 @@ namespace PANSFEM2 {
 				B(2, 2 * n) = dNdX(1, n);	B(2, 2 * n + 1) = dNdX(0, n);	
 			}
 
-			_Ke += B.Transpose()*D*B*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, B, D, J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
+		}
+	}
+
+
+	//******************************Make element stiffness matrix with geometry cache******************************
+	template<class T, template<class>class SF, template<class>class IC>
+	void PlaneStrainStiffness(Matrix<T>& _Ke, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, const ElementGeometryCache<T, SF, IC>& _cache, int _id, T _E, T _V, T _t) {
+		assert(_doulist.size() == 2);
+
+		_Ke = Matrix<T>(2*_element.size(), 2*_element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 2*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 2*i + 1);
+		}
+
+		Matrix<T> D = Matrix<T>(3, 3);
+		D(0, 0) = 1.0 - _V;	D(0, 1) = _V;		D(0, 2) = T();
+		D(1, 0) = D(0, 1);	D(1, 1) = 1.0 - _V;	D(1, 2) = T();
+		D(2, 0) = D(0, 2);	D(2, 1) = D(1, 2);	D(2, 2) = 0.5*(1.0 - 2.0*_V);
+		D *= _E / ((1.0 - 2.0*_V)*(1.0 + _V));
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& dNdX = _cache.dNdX(_id, g);
+
+			Matrix<T> B = Matrix<T>(3, 2*_element.size());
+			for (int n = 0; n < _element.size(); n++) {
+				B(0, 2 * n) = dNdX(0, n);	B(0, 2 * n + 1) = T();			
+				B(1, 2 * n) = T();			B(1, 2 * n + 1) = dNdX(1, n);	
+				B(2, 2 * n) = dNdX(1, n);	B(2, 2 * n + 1) = dNdX(0, n);	
+			}
+
+			AddBtDB(_Ke, B, D, _cache.JW(_id, g)*_t);
+		}
+	}
+
+
+	//******************************Make element stiffness matrices of elements in [_begin, _end) at once******************************
+	//	Elements are evaluated in batches of W with structure-of-arrays layout [value][lane], 
+	//	so that the loops over lanes (= elements) are vectorized.
+	template<class T, template<class>class SF, template<class>class IC>
+	void PlaneStrainStiffnessBatch(std::vector<Matrix<T> >& _Kes, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<std::vector<int> >& _elements, int _begin, int _end, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, T _E, T _V, T _t) {
+		assert(_doulist.size() == 2 && SF<T>::d == 2);
+		assert(0 <= _begin && _begin <= _end && _end <= _elements.size());
+
+		const int W = 8;				//	Number of lanes
+		const int n = SF<T>::n;			//	Number of nodes
+		const int m = 2*n;				//	Number of DOFs
+
+		_Kes = std::vector<Matrix<T> >(_end - _begin);
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(n, std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < n; i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 2*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 2*i + 1);
+		}
+
+		T d11 = _E*(1.0 - _V)/((1.0 - 2.0*_V)*(1.0 + _V));
+		T d12 = _E*_V/((1.0 - 2.0*_V)*(1.0 + _V));
+		T d33 = _E*0.5*(1.0 - 2.0*_V)/((1.0 - 2.0*_V)*(1.0 + _V));
+
+		std::vector<T> X = std::vector<T>(2*n*W);		//	Nodal coordinates [2*i + k][lane]
+		std::vector<T> dNdX = std::vector<T>(2*n*W);	//	Derivatives of shape functions [2*i + k][lane]
+		std::vector<T> Ke = std::vector<T>(m*m*W);		//	Element stiffness matrices [p*m + q][lane]
+		T w[W];
+
+		for(int head = _begin; head < _end; head += W) {
+			int nw = std::min(W, _end - head);
+			std::fill(Ke.begin(), Ke.end(), T());
+			for(int l = 0; l < W; l++) {
+				const std::vector<int>& element = _elements[l < nw ? head + l : head];
+				assert(element.size() == n);
+				for(int i = 0; i < n; i++) {
+					X[(2*i)*W + l] = _x[element[i]](0);
+					X[(2*i + 1)*W + l] = _x[element[i]](1);
+				}
+			}
+
+			for(int g = 0; g < IC<T>::N; g++) {
+				T dNdr[2][n];
+				for(int i = 0; i < n; i++) {
+					dNdr[0][i] = ReferenceElement<T, SF, IC>::dNdr(g)(0, i);
+					dNdr[1][i] = ReferenceElement<T, SF, IC>::dNdr(g)(1, i);
+				}
+				T wg = _t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+
+#pragma omp simd
+				for(int l = 0; l < W; l++) {
+					T J00 = T(), J01 = T(), J10 = T(), J11 = T();
+					for(int i = 0; i < n; i++) {
+						J00 += dNdr[0][i]*X[(2*i)*W + l];	J01 += dNdr[0][i]*X[(2*i + 1)*W + l];
+						J10 += dNdr[1][i]*X[(2*i)*W + l];	J11 += dNdr[1][i]*X[(2*i + 1)*W + l];
+					}
+					T J = J00*J11 - J01*J10;
+					for(int i = 0; i < n; i++) {
+						dNdX[(2*i)*W + l] = (J11*dNdr[0][i] - J01*dNdr[1][i])/J;
+						dNdX[(2*i + 1)*W + l] = (- J10*dNdr[0][i] + J00*dNdr[1][i])/J;
+					}
+					w[l] = J*wg;
+				}
+
+				for(int i = 0; i < n; i++) {
+					for(int j = 0; j < n; j++) {
+						T* K00 = &Ke[((2*i)*m + 2*j)*W];
+						T* K01 = &Ke[((2*i)*m + 2*j + 1)*W];
+						T* K10 = &Ke[((2*i + 1)*m + 2*j)*W];
+						T* K11 = &Ke[((2*i + 1)*m + 2*j + 1)*W];
+						const T* dNidX = &dNdX[(2*i)*W];
+						const T* dNidY = &dNdX[(2*i + 1)*W];
+						const T* dNjdX = &dNdX[(2*j)*W];
+						const T* dNjdY = &dNdX[(2*j + 1)*W];
+#pragma omp simd
+						for(int l = 0; l < W; l++) {
+							K00[l] += w[l]*(dNidX[l]*d11*dNjdX[l] + dNidY[l]*d33*dNjdY[l]);
+							K01[l] += w[l]*(dNidX[l]*d12*dNjdY[l] + dNidY[l]*d33*dNjdX[l]);
+							K10[l] += w[l]*(dNidY[l]*d12*dNjdX[l] + dNidX[l]*d33*dNjdY[l]);
+							K11[l] += w[l]*(dNidY[l]*d11*dNjdY[l] + dNidX[l]*d33*dNjdX[l]);
+						}
+					}
+				}
+			}
+
+			for(int l = 0; l < nw; l++) {
+				Matrix<T>& Kel = _Kes[head - _begin + l];
+				Kel = Matrix<T>(m, m);
+				for(int p = 0; p < m; p++) {
+					for(int q = 0; q < m; q++) {
+						Kel(p, q) = Ke[(p*m + q)*W + l];
+					}
+				}
+			}
 		}
 	}
 
@@ -84,7 +217,7 @@ namespace PANSFEM2 {
 		Dvol *= _E/(3.0*(1.0 - 2.0*_V));
 
 		for (int g = 0; g < ICV<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(ICV<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, ICV>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -96,7 +229,7 @@ namespace PANSFEM2 {
 				B(2, 2 * n) = dNdX(1, n);	B(2, 2 * n + 1) = dNdX(0, n);	
 			}
 
-			_Ke += B.Transpose()*Dvol*B*J*_t*ICV<T>::Weights[g][0]*ICV<T>::Weights[g][1];
+			AddBtDB(_Ke, B, Dvol, J*_t*ICV<T>::Weights[g][0]*ICV<T>::Weights[g][1]);
 		}
 
 		//----------Integraion deviation strain term----------
@@ -107,7 +240,7 @@ namespace PANSFEM2 {
 		Ddev *= _E/(6.0*(1.0 + _V));
 
 		for (int g = 0; g < ICD<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(ICD<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, ICD>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -119,7 +252,7 @@ namespace PANSFEM2 {
 				B(2, 2 * n) = dNdX(1, n);	B(2, 2 * n + 1) = dNdX(0, n);	
 			}
 
-			_Ke += B.Transpose()*Ddev*B*J*_t*ICD<T>::Weights[g][0]*ICD<T>::Weights[g][1];
+			AddBtDB(_Ke, B, Ddev, J*_t*ICD<T>::Weights[g][0]*ICD<T>::Weights[g][1]);
 		}
 	}
 
@@ -150,7 +283,7 @@ namespace PANSFEM2 {
 
 		//----------Integraion volume strain term----------
 		for (int g = 0; g < ICV<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(ICV<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, ICV>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -162,12 +295,12 @@ namespace PANSFEM2 {
 				Bvol(2, 2*n) = T();				Bvol(2, 2*n + 1) = T();	
 			}
 
-			_Ke += Bvol.Transpose()*D*Bvol*J*_t*ICV<T>::Weights[g][0]*ICV<T>::Weights[g][1];
+			AddBtDB(_Ke, Bvol, D, J*_t*ICV<T>::Weights[g][0]*ICV<T>::Weights[g][1]);
 		}
 
 		//----------Integraion deviation strain term----------
 		for (int g = 0; g < ICD<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(ICD<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, ICD>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -179,7 +312,7 @@ namespace PANSFEM2 {
 				Bdev(2, 2*n) = dNdX(1, n);		Bdev(2, 2*n + 1) = dNdX(0, n);	
 			}
 
-			_Ke += Bdev.Transpose()*D*Bdev*J*_t*ICD<T>::Weights[g][0]*ICD<T>::Weights[g][1];
+			AddBtDB(_Ke, Bdev, D, J*_t*ICD<T>::Weights[g][0]*ICD<T>::Weights[g][1]);
 		}
 	}
 
@@ -211,7 +344,7 @@ namespace PANSFEM2 {
 		D *= _E/((1.0 - 2.0*_V)*(1.0 + _V));
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -234,8 +367,8 @@ namespace PANSFEM2 {
 			G(1, 0) = T();			G(1, 1) = dPdX(1, 0);	G(1, 2) = T();			G(1, 3) = dPdX(1, 1);
 			G(2, 0) = dPdX(1, 0);	G(2, 1) = dPdX(0, 0);	G(2, 2) = dPdX(1, 1);	G(2, 3) = dPdX(0, 1);
 
-			_Ke += B.Transpose()*D*B*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
-			Keaa += G.Transpose()*D*G*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, B, D, J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
+			AddBtDB(Keaa, G, D, J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 			Kead += G.Transpose()*D*B*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
 		}
 
@@ -273,7 +406,7 @@ namespace PANSFEM2 {
 		D *= _E/((1.0 - 2.0*_V)*(1.0 + _V));
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -287,7 +420,7 @@ namespace PANSFEM2 {
 				BL(2, 2*n) = F(0, 1)*dNdX(0, n) + F(0, 0)*dNdX(1, n);	BL(2, 2*n + 1) = F(1, 1)*dNdX(0, n) + F(1, 0)*dNdX(1, n);
 			}
 
-			_Ke += BL.Transpose()*D*BL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, BL, D, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 
 			Matrix<T> E = (Z + Z.Transpose() + Z.Transpose()*Z)/2.0;
 			Vector<T> Ev = Vector<T>({ E(0, 0), E(1, 1), E(0, 1) + E(1, 0) });
@@ -305,13 +438,58 @@ namespace PANSFEM2 {
 			Matrix<T> S10 = Sv(2)*Identity<T>(2);	Matrix<T> S11 = Sv(1)*Identity<T>(2);
 			Matrix<T> S = (S00.Hstack(S01)).Vstack((S10.Hstack(S11)));
 
-			_Ke += BNL.Transpose()*S*BNL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, BNL, S, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 
 			_Fe -= BL.Transpose()*Sv*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
 		}
 	}
 
 
+	//******************************Make element residual vector with TotalLagrange without tangent******************************
+	template<class T, template<class>class SF, template<class>class IC>
+	void PlaneStrainTotalLagrangeResidual(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V, T _t) {
+		assert(_doulist.size() == 2);
+
+		_Fe = Vector<T>(2*_element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 2*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 2*i + 1);
+		}
+
+		Matrix<T> X = Matrix<T>(_element.size(), 2);
+		Matrix<T> U = Matrix<T>(_element.size(), 2);
+		for(int i = 0; i < _element.size(); i++){
+			X(i, 0) = _x[_element[i]](0);	X(i, 1) = _x[_element[i]](1);
+			U(i, 0) = _u[_element[i]](0);	U(i, 1) = _u[_element[i]](1);
+		}
+
+		T lambda = _E*_V/((1.0 - 2.0*_V)*(1.0 + _V));
+		T mu = 0.5*_E/(1.0 + _V);
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+			Matrix<T> dXdr = dNdr*X;
+			T J = dXdr.Determinant();
+			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
+
+			Matrix<T> Z = (dNdX*U).Transpose();
+			Matrix<T> F = Identity<T>(2) + Z;
+			Matrix<T> E = (Z + Z.Transpose() + Z.Transpose()*Z)/2.0;
+
+			//----------Second Piola-Kirchhoff stress S and first Piola-Kirchhoff stress P = F*S----------
+			Matrix<T> S = 2.0*mu*E + (lambda*(E(0, 0) + E(1, 1)))*Identity<T>(2);
+			Matrix<T> P = F*S;
+
+			T w = J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			for (int n = 0; n < _element.size(); n++) {
+				_Fe(2*n) -= (P(0, 0)*dNdX(0, n) + P(0, 1)*dNdX(1, n))*w;
+				_Fe(2*n + 1) -= (P(1, 0)*dNdX(0, n) + P(1, 1)*dNdX(1, n))*w;
+			}
+		}
+	}
+
+
 	//******************************Make element tangent stiffness matrix and residual vector with UpdatedLagrange******************************
 	template<class T, template<class>class SF, template<class>class IC>
 	void PlaneStrainStiffnessUpdatedLagrange(Matrix<T>& _Ke, Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V, T _t) {
@@ -341,7 +519,7 @@ namespace PANSFEM2 {
 		T lambda0 = 2.0*mu0*_V/(1.0 - 2.0*_V);
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dxdr = dNdr*x;
 			T J = dxdr.Determinant();
 			Matrix<T> dNdx = dxdr.Inverse()*dNdr;
@@ -360,7 +538,7 @@ namespace PANSFEM2 {
 				BL(1, 2*n) = T();			BL(1, 2*n + 1) = dNdx(1, n);
 				BL(2, 2*n) = dNdx(1, n);	BL(2, 2*n + 1) = dNdx(0, n);
 			}
-			_Ke += BL.Transpose()*C*BL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, BL, C, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 
 			Matrix<T> S = (mu0/detF)*(F*F.Transpose() - Identity<T>(2)) + (lambda0*log(detF)/detF)*Identity<T>(2);
 			Matrix<T> BNL = Matrix<T>(4, 2*_element.size());
@@ -373,7 +551,7 @@ namespace PANSFEM2 {
 			Matrix<T> S00 = S(0, 0)*Identity<T>(2);	Matrix<T> S01 = S(0, 1)*Identity<T>(2);
 			Matrix<T> S10 = S(1, 0)*Identity<T>(2);	Matrix<T> S11 = S(1, 1)*Identity<T>(2);
 			Matrix<T> Sm = (S00.Hstack(S01)).Vstack((S10.Hstack(S11)));
-			_Ke += BNL.Transpose()*Sm*BNL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, BNL, Sm, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 
 			Vector<T> Sv = { S(0, 0), S(1, 1), S(0, 1) };
 			_Fe -= BL.Transpose()*Sv*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
@@ -381,6 +559,94 @@ namespace PANSFEM2 {
 	}
 
 
+	//******************************Make element residual vector with UpdatedLagrange without tangent******************************
+	template<class T, template<class>class SF, template<class>class IC>
+	void PlaneStrainUpdatedLagrangeResidual(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V, T _t) {
+		assert(_doulist.size() == 2);
+
+		_Fe = Vector<T>(2*_element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 2*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 2*i + 1);
+		}
+
+		Matrix<T> X = Matrix<T>(_element.size(), 2);
+		Matrix<T> U = Matrix<T>(_element.size(), 2);
+		for(int i = 0; i < _element.size(); i++){
+			X(i, 0) = _x[_element[i]](0);	X(i, 1) = _x[_element[i]](1);
+			U(i, 0) = _u[_element[i]](0);	U(i, 1) = _u[_element[i]](1);
+		}
+
+		Matrix<T> x = X + U;
+
+		T mu0 = 0.5*_E/(1.0 + _V);
+		T lambda0 = 2.0*mu0*_V/(1.0 - 2.0*_V);
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+			Matrix<T> dxdr = dNdr*x;
+			T J = dxdr.Determinant();
+			Matrix<T> dNdx = dxdr.Inverse()*dNdr;
+			Matrix<T> F = ((dNdr*X).Inverse()*dNdr*x).Transpose();
+
+			T detF = F.Determinant();
+			Matrix<T> S = (mu0/detF)*(F*F.Transpose() - Identity<T>(2)) + (lambda0*log(detF)/detF)*Identity<T>(2);
+
+			T w = J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			for (int n = 0; n < _element.size(); n++) {
+				_Fe(2*n) -= (S(0, 0)*dNdx(0, n) + S(0, 1)*dNdx(1, n))*w;
+				_Fe(2*n + 1) -= (S(1, 0)*dNdx(0, n) + S(1, 1)*dNdx(1, n))*w;
+			}
+		}
+	}
+
+
+	//******************************Make element internal force vector Ke*ue without element matrix******************************
+	template<class T, template<class>class SF, template<class>class IC>
+	void PlaneStrainInternalForce(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V, T _t) {
+		assert(_doulist.size() == 2);
+
+		_Fe = Vector<T>(2*_element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 2*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 2*i + 1);
+		}
+
+		Matrix<T> X = Matrix<T>(_element.size(), 2);
+		Matrix<T> u = Matrix<T>(_element.size(), 2);
+		for(int i = 0; i < _element.size(); i++){
+			X(i, 0) = _x[_element[i]](0);
+			X(i, 1) = _x[_element[i]](1);
+			u(i, 0) = _u[_element[i]](_doulist[0]);
+			u(i, 1) = _u[_element[i]](_doulist[1]);
+		}
+
+		T lambda = _E*_V/((1.0 - 2.0*_V)*(1.0 + _V));
+		T mu = 0.5*_E/(1.0 + _V);
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+			Matrix<T> dXdr = dNdr*X;
+			T J = dXdr.Determinant();
+			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
+			Matrix<T> dudX = dNdX*u;
+
+			T trace = dudX(0, 0) + dudX(1, 1);
+			T sxx = lambda*trace + 2.0*mu*dudX(0, 0);
+			T syy = lambda*trace + 2.0*mu*dudX(1, 1);
+			T sxy = mu*(dudX(0, 1) + dudX(1, 0));
+
+			T w = J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			for (int n = 0; n < _element.size(); n++) {
+				_Fe(2*n) += (dNdX(0, n)*sxx + dNdX(1, n)*sxy)*w;
+				_Fe(2*n + 1) += (dNdX(1, n)*syy + dNdX(0, n)*sxy)*w;
+			}
+		}
+	}
+
+
 	//******************************Make element mass matrix******************************
 	template<class T, template<class>class SF, template<class>class IC>
 	void PlaneStrainMass(Matrix<T>& _Me, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, T _rho, T _t) {
@@ -400,8 +666,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 
@@ -435,8 +701,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Vector<T> x = X.Transpose()*N;
 			Matrix<T> dXdr = dNdr*X;
 			T dl = sqrt((dXdr*dXdr.Transpose())(0, 0));
@@ -478,8 +744,8 @@ namespace PANSFEM2 {
 		Matrix<T> x = X + U;
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dxdr = dNdr*x;
 			
 			Matrix<T> K = Matrix<T>(2*_element.size(), 2*_element.size());
@@ -517,8 +783,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Vector<T> x = X.Transpose()*N;
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -41,7 +42,7 @@ namespace PANSFEM2 {
 		D *= _E/((1.0 - _V)*(1.0 + _V));
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -53,7 +54,7 @@ namespace PANSFEM2 {
 				B(2, 2 * n) = dNdX(1, n);	B(2, 2 * n + 1) = dNdX(0, n);	
 			}
 
-			_Ke += B.Transpose()*D*B*J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+			AddBtDB(_Ke, B, D, J*_t*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]);
 		}
 	}
 
@@ -77,8 +78,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 
@@ -112,8 +113,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Vector<T> x = X.Transpose()*N;
 			Matrix<T> dXdr = dNdr*X;
 			T dl = sqrt((dXdr*dXdr.Transpose())(0, 0));
@@ -148,8 +149,8 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Vector<T> x = X.Transpose()*N;
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -33,8 +34,8 @@ namespace PANSFEM2 {
 		}
 
         for (int g = 0; g < IC<T>::N; g++) {
-            Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-            Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+            const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+            const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -61,7 +62,7 @@ namespace PANSFEM2 {
 
         T Area = T();
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();            
 			Area += J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
@@ -87,7 +88,7 @@ namespace PANSFEM2 {
 		}
 
         for (int g = 0; g < IC<T>::N; g++) {
-            Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+            const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -118,8 +119,8 @@ namespace PANSFEM2 {
         }
 
         for (int g = 0; g < IC<T>::N; g++) {
-            Vector<T> N = SF<T>::N(IC<T>::Points[g]);
-            Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+            const Vector<T>& N = ReferenceElement<T, SF, IC>::N(g);
+            const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
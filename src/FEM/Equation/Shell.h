@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -61,8 +62,8 @@ namespace PANSFEM2 {
 
 		for (int g = 0; g < IC01<T>::N; g++) {
             for(int h = 0; h < IC2<T>::N; h++){
-                Vector<T> N = SF<T>::N(IC01<T>::Points[g]);
-                Matrix<T> dNdr = SF<T>::dNdr(IC01<T>::Points[g]);
+                const Vector<T>& N = ReferenceElement<T, SF, IC01>::N(g);
+                const Matrix<T>& dNdr = ReferenceElement<T, SF, IC01>::dNdr(g);
            
                 Vector<T> zeta = IC2<T>::Points[h];
                 Matrix<T> J = (dNdr*(X + 0.5*_t*zeta(0)*v3)).Vstack(0.5*_t*N.Transpose()*v3);
@@ -94,7 +95,7 @@ namespace PANSFEM2 {
                 P(4, 0) = 2.0*P1(0)*P2(0);  P(4, 1) = 2.0*P1(1)*P2(1);  P(4, 2) = 2.0*P1(2)*P2(2);  P(4, 3) = P1(0)*P2(1) + P1(1)*P2(0);    P(4, 4) = P1(0)*P2(2) + P1(2)*P2(0);    P(4, 5) = P1(1)*P2(2) + P1(2)*P2(1);        
                 Matrix<T> D = P.Transpose()*D0*P;
 
-                _Ke += B.Transpose()*D*B*detJ*IC01<T>::Weights[g][0]*IC01<T>::Weights[g][1]*IC2<T>::Weights[h][0];
+                AddBtDB(_Ke, B, D, detJ*IC01<T>::Weights[g][0]*IC01<T>::Weights[g][1]*IC2<T>::Weights[h][0]);
             }
 		}
 	}
@@ -146,8 +147,8 @@ namespace PANSFEM2 {
 
 		for (int g = 0; g < IC01<T>::N; g++) {
             for(int h = 0; h < IC2<T>::N; h++){
-                Vector<T> N = SF<T>::N(IC01<T>::Points[g]);
-                Matrix<T> dNdr = SF<T>::dNdr(IC01<T>::Points[g]);
+                const Vector<T>& N = ReferenceElement<T, SF, IC01>::N(g);
+                const Matrix<T>& dNdr = ReferenceElement<T, SF, IC01>::dNdr(g);
            
                 Vector<T> zeta = IC2<T>::Points[h];
                 Matrix<T> J = (dNdr*(X + 0.5*_t*zeta(0)*v3)).Vstack(0.5*_t*N.Transpose()*v3);
@@ -179,7 +180,7 @@ namespace PANSFEM2 {
                 P(4, 0) = 2.0*P1(0)*P2(0);  P(4, 1) = 2.0*P1(1)*P2(1);  P(4, 2) = 2.0*P1(2)*P2(2);  P(4, 3) = P1(0)*P2(1) + P1(1)*P2(0);    P(4, 4) = P1(0)*P2(2) + P1(2)*P2(0);    P(4, 5) = P1(1)*P2(2) + P1(2)*P2(1);        
                 Matrix<T> D = P.Transpose()*D0*P;
 
-                _Ke += B.Transpose()*D*B*detJ*IC01<T>::Weights[g][0]*IC01<T>::Weights[g][1]*IC2<T>::Weights[h][0];
+                AddBtDB(_Ke, B, D, detJ*IC01<T>::Weights[g][0]*IC01<T>::Weights[g][1]*IC2<T>::Weights[h][0]);
             }
 		}
 	}
@@ -13,6 +13,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -44,7 +45,7 @@ namespace PANSFEM2 {
 		C *= _E/((1.0 + _V)*(1.0 - 2.0*_V));
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -59,7 +60,57 @@ namespace PANSFEM2 {
 				B(5, 3*n) = dNdX(2, n);	B(5, 3*n + 1) = T();		B(5, 3*n + 2) = dNdX(0, n);
 			}
 
-			_Ke += B.Transpose()*C*B*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			AddBtDB(_Ke, B, C, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2]);
+		}
+	}
+
+
+	//********************Internal force vector Ke*ue of Linear Isotropic Elastic Solid 3D without element matrix********************
+	template<class T, template<class>class SF, template<class>class IC>
+	void SolidLinearIsotropicElasticInternalForce(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V) {
+		assert(_doulist.size() == 3);
+
+		_Fe = Vector<T>(3*_element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(3));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 3*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 3*i + 1);
+			_nodetoelement[i][2] = std::make_pair(_doulist[2], 3*i + 2);
+		}
+		
+		Matrix<T> X = Matrix<T>(_element.size(), 3);
+		Matrix<T> u = Matrix<T>(_element.size(), 3);
+		for(int i = 0; i < _element.size(); i++){
+			X(i, 0) = _x[_element[i]](0);	X(i, 1) = _x[_element[i]](1);	X(i, 2) = _x[_element[i]](2);
+			u(i, 0) = _u[_element[i]](_doulist[0]);	u(i, 1) = _u[_element[i]](_doulist[1]);	u(i, 2) = _u[_element[i]](_doulist[2]);
+		}
+
+		T lambda = _E*_V/((1.0 + _V)*(1.0 - 2.0*_V));
+		T mu = 0.5*_E/(1.0 + _V);
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+			Matrix<T> dXdr = dNdr*X;
+			T J = dXdr.Determinant();
+			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
+			Matrix<T> dudX = dNdX*u;
+
+			//----------Cauchy stress S = lambda*tr(e)*I + 2*mu*e----------
+			T trace = dudX(0, 0) + dudX(1, 1) + dudX(2, 2);
+			Matrix<T> S = Matrix<T>(3, 3);
+			for(int i = 0; i < 3; i++){
+				for(int j = 0; j < 3; j++){
+					S(i, j) = mu*(dudX(i, j) + dudX(j, i));
+				}
+				S(i, i) += lambda*trace;
+			}
+
+			T w = J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			for (int n = 0; n < _element.size(); n++) {
+				for(int i = 0; i < 3; i++){
+					_Fe(3*n + i) += (dNdX(0, n)*S(0, i) + dNdX(1, n)*S(1, i) + dNdX(2, n)*S(2, i))*w;
+				}
+			}
 		}
 	}
 
@@ -98,7 +149,7 @@ namespace PANSFEM2 {
 		C *= _E/((1.0 + _V)*(1.0 - 2.0*_V));
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*X;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
@@ -115,7 +166,7 @@ namespace PANSFEM2 {
 				BL(5, 3*n) = F(0, 0)*dNdX(2, n) + F(0, 2)*dNdX(0, n);	BL(5, 3*n + 1) = F(1, 0)*dNdX(2, n) + F(1, 2)*dNdX(0, n);	BL(5, 3*n + 2) = F(2, 0)*dNdX(2, n) + F(2, 2)*dNdX(0, n);
 			}
 
-			_Ke += BL.Transpose()*C*BL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			AddBtDB(_Ke, BL, C, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2]);
 
 			Matrix<T> E = (Z + Z.Transpose() + Z.Transpose()*Z)/2.0;
 			Vector<T> Ev = Vector<T>({ E(0, 0), E(1, 1), E(2, 2), E(0, 1) + E(1, 0), E(1, 2) + E(2, 1), E(2, 0) + E(0, 2) });
@@ -139,13 +190,60 @@ namespace PANSFEM2 {
 			Matrix<T> S20 = Sv(5)*Identity<T>(3);	Matrix<T> S21 = Sv(4)*Identity<T>(3);	Matrix<T> S22 = Sv(2)*Identity<T>(3);
 			Matrix<T> S = (S00.Hstack(S01.Hstack(S02))).Vstack((S10.Hstack(S11.Hstack(S12))).Vstack((S20.Hstack(S21.Hstack(S22)))));
 
-			_Ke += BNL.Transpose()*S*BNL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			AddBtDB(_Ke, BNL, S, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2]);
 
 			_Fe -= BL.Transpose()*Sv*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
 		}
 	}
 
 
+	//********************Residual vector of Total Lagrange Solid 3D without tangent********************
+	template<class T, template<class>class SF, template<class>class IC>
+	void SolidTotalLagrangeResidual(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V) {
+		assert(_doulist.size() == 3);
+
+		_Fe = Vector<T>(3*_element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(3));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 3*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 3*i + 1);
+			_nodetoelement[i][2] = std::make_pair(_doulist[2], 3*i + 2);
+		}
+		
+		Matrix<T> X = Matrix<T>(_element.size(), 3);
+		Matrix<T> U = Matrix<T>(_element.size(), 3);
+		for(int i = 0; i < _element.size(); i++){
+			X(i, 0) = _x[_element[i]](0);	X(i, 1) = _x[_element[i]](1);	X(i, 2) = _x[_element[i]](2);
+			U(i, 0) = _u[_element[i]](0);	U(i, 1) = _u[_element[i]](1);	U(i, 2) = _u[_element[i]](2);
+		}
+
+		T lambda = _E*_V/((1.0 + _V)*(1.0 - 2.0*_V));
+		T mu = 0.5*_E/(1.0 + _V);
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+			Matrix<T> dXdr = dNdr*X;
+			T J = dXdr.Determinant();
+			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
+
+			Matrix<T> Z = (dNdX*U).Transpose();
+			Matrix<T> F = Identity<T>(3) + Z;
+			Matrix<T> E = (Z + Z.Transpose() + Z.Transpose()*Z)/2.0;
+
+			//----------Second Piola-Kirchhoff stress S and first Piola-Kirchhoff stress P = F*S----------
+			Matrix<T> S = 2.0*mu*E + (lambda*(E(0, 0) + E(1, 1) + E(2, 2)))*Identity<T>(3);
+			Matrix<T> P = F*S;
+
+			T w = J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			for (int n = 0; n < _element.size(); n++) {
+				for (int a = 0; a < 3; a++) {
+					_Fe(3*n + a) -= (P(a, 0)*dNdX(0, n) + P(a, 1)*dNdX(1, n) + P(a, 2)*dNdX(2, n))*w;
+				}
+			}
+		}
+	}
+
+
 	//********************Updated Lagrange Solid 3D********************
 	template<class T, template<class>class SF, template<class>class IC>
 	void SolidUpdatedLagrange(Matrix<T>& _Ke, Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V) {
@@ -176,7 +274,7 @@ namespace PANSFEM2 {
 		T lambda0 = 2.0*mu0*_V/(1.0 - 2.0*_V);
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SF<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
 			Matrix<T> dxdr = dNdr*x;
 			T J = dxdr.Determinant();
 			Matrix<T> dNdx = dxdr.Inverse()*dNdr;
@@ -201,7 +299,7 @@ namespace PANSFEM2 {
 				BL(4, 3*n) = dNdx(2, n);	BL(4, 3*n + 1) = T();			BL(4, 3*n + 2) = dNdx(0, n);
 				BL(5, 3*n) = T();			BL(5, 3*n + 1) = dNdx(2, n);	BL(5, 3*n + 2) = dNdx(1, n);
 			}
-			_Ke += BL.Transpose()*C*BL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			AddBtDB(_Ke, BL, C, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2]);
 
 			Matrix<T> S = (mu0/detF)*(F*F.Transpose() - Identity<T>(3)) + (lambda0*log(detF)/detF)*Identity<T>(3);
 			Matrix<T> BNL = Matrix<T>(9, 3*_element.size());
@@ -220,10 +318,55 @@ namespace PANSFEM2 {
 			Matrix<T> S10 = S(1, 0)*Identity<T>(3);	Matrix<T> S11 = S(1, 1)*Identity<T>(3);	Matrix<T> S12 = S(1, 2)*Identity<T>(3);
 			Matrix<T> S20 = S(2, 0)*Identity<T>(3);	Matrix<T> S21 = S(2, 1)*Identity<T>(3);	Matrix<T> S22 = S(2, 2)*Identity<T>(3);
 			Matrix<T> Sm = (S00.Hstack(S01.Hstack(S02))).Vstack((S10.Hstack(S11.Hstack(S12))).Vstack((S20.Hstack(S21.Hstack(S22)))));
-			_Ke += BNL.Transpose()*Sm*BNL*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			AddBtDB(_Ke, BNL, Sm, J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2]);
 
 			Vector<T> Sv = Vector<T>({ S(0, 0), S(1, 1), S(2, 2), S(0, 1), S(0, 2), S(1, 2) });	
 			_Fe -= BL.Transpose()*Sv*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
 		}
 	}
+
+
+	//********************Residual vector of Updated Lagrange Solid 3D without tangent********************
+	template<class T, template<class>class SF, template<class>class IC>
+	void SolidUpdatedLagrangeResidual(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelement, const std::vector<int>& _element, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, std::vector<Vector<T> >& _u, T _E, T _V) {
+		assert(_doulist.size() == 3);
+
+		_Fe = Vector<T>(3*_element.size());
+		_nodetoelement = std::vector<std::vector<std::pair<int, int> > >(_element.size(), std::vector<std::pair<int, int> >(3));
+		for(int i = 0; i < _element.size(); i++) {
+			_nodetoelement[i][0] = std::make_pair(_doulist[0], 3*i);
+			_nodetoelement[i][1] = std::make_pair(_doulist[1], 3*i + 1);
+			_nodetoelement[i][2] = std::make_pair(_doulist[2], 3*i + 2);
+		}
+		
+		Matrix<T> X = Matrix<T>(_element.size(), 3);
+		Matrix<T> U = Matrix<T>(_element.size(), 3);
+		for(int i = 0; i < _element.size(); i++){
+			X(i, 0) = _x[_element[i]](0);	X(i, 1) = _x[_element[i]](1);	X(i, 2) = _x[_element[i]](2);
+			U(i, 0) = _u[_element[i]](0);	U(i, 1) = _u[_element[i]](1);	U(i, 2) = _u[_element[i]](2);
+		}
+
+		Matrix<T> x = X + U;
+
+		T mu0 = 0.5*_E/(1.0 + _V);
+		T lambda0 = 2.0*mu0*_V/(1.0 - 2.0*_V);
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Matrix<T>& dNdr = ReferenceElement<T, SF, IC>::dNdr(g);
+			Matrix<T> dxdr = dNdr*x;
+			T J = dxdr.Determinant();
+			Matrix<T> dNdx = dxdr.Inverse()*dNdr;
+			Matrix<T> F = ((dNdr*X).Inverse()*dNdr*x).Transpose();	
+
+			T detF = F.Determinant();
+			Matrix<T> S = (mu0/detF)*(F*F.Transpose() - Identity<T>(3)) + (lambda0*log(detF)/detF)*Identity<T>(3);
+
+			T w = J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1]*IC<T>::Weights[g][2];
+			for (int n = 0; n < _element.size(); n++) {
+				for (int a = 0; a < 3; a++) {
+					_Fe(3*n + a) -= (S(a, 0)*dNdx(0, n) + S(a, 1)*dNdx(1, n) + S(a, 2)*dNdx(2, n))*w;
+				}
+			}
+		}
+	}
 }
\ No newline at end of file
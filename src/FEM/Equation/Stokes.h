@@ -12,6 +12,7 @@
 
 #include "../../LinearAlgebra/Models/Matrix.h"
 #include "../../LinearAlgebra/Models/Vector.h"
+#include "../Controller/ReferenceElement.h"
 
 
 namespace PANSFEM2 {
@@ -45,14 +46,13 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			Matrix<T> dNdX = dXdr.Inverse()*dNdr;
 
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
-			Matrix<T> dMdr = SFU<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dMdr = ReferenceElement<T, SFU, IC>::dNdr(g);
 			Matrix<T> dMdX = dXdr.Inverse()*dMdr;
 
             Matrix<T> K = Matrix<T>(2*m + n, 2*m + n);
@@ -104,11 +104,11 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
 			
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
 
             Matrix<T> C = Matrix<T>(2*m + n, 2*m + n);
             for(int i = 0; i < m; i++){
@@ -123,6 +123,47 @@ namespace PANSFEM2 {
 	}
 
 
+	//******************************Get element pressure mass matrix for Schur complement preconditioner******************************
+	template<class T, template<class>class SFU, template<class>class SFP, template<class>class IC>
+	void StokesPressureMass(Matrix<T>& _Me, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementu, const std::vector<int>& _elementu, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementp, const std::vector<int>& _elementp, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, T _c) {
+		assert(_doulist.size() == 3);
+
+		int m = _elementu.size();   //  Number of shapefunction for velosity u
+        int n = _elementp.size();   //  Number of shapefunction for pressure p
+
+		_Me = Matrix<T>(2*m + n, 2*m + n);
+		_nodetoelementu = std::vector<std::vector<std::pair<int, int> > >(m, std::vector<std::pair<int, int> >(2));
+		for(int i = 0; i < m; i++) {
+			_nodetoelementu[i][0] = std::make_pair(_doulist[0], i);
+			_nodetoelementu[i][1] = std::make_pair(_doulist[1], m + i);
+		}
+        _nodetoelementp = std::vector<std::vector<std::pair<int, int> > >(n, std::vector<std::pair<int, int> >(1));
+		for(int i = 0; i < n; i++) {
+			_nodetoelementp[i][0] = std::make_pair(_doulist[2], 2*m + i);
+		}
+
+        Matrix<T> Xp = Matrix<T>(n, 2);
+		for(int i = 0; i < n; i++){
+			Xp(i, 0) = _x[_elementp[i]](0); Xp(i, 1) = _x[_elementp[i]](1);
+		}
+
+		for (int g = 0; g < IC<T>::N; g++) {
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
+			Matrix<T> dXdr = dNdr*Xp;
+			T J = dXdr.Determinant();
+
+            Matrix<T> Mp = Matrix<T>(2*m + n, 2*m + n);
+            for(int i = 0; i < n; i++){
+                for(int j = 0; j < n; j++){
+                    Mp(i + 2*m, j + 2*m) = _c*N(i)*N(j);
+                }
+            }
+			_Me += Mp*J*IC<T>::Weights[g][0]*IC<T>::Weights[g][1];
+		}
+	}
+
+
 	//******************************Get element traction vector******************************
     template<class T, template<class>class SFU, template<class>class SFP, template<class>class IC, class F>
     void StokesSurfaceForce(Vector<T>& _Fe, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementu, const std::vector<int>& _elementu, std::vector<std::vector<std::pair<int, int> > >& _nodetoelementp, const std::vector<int>& _elementp, const std::vector<int>& _doulist, std::vector<Vector<T> >& _x, F _f){
@@ -153,13 +194,13 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-            Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+            const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
             Vector<T> x = Xp.Transpose()*N;
 			Matrix<T> dXdr = dNdr*Xp;
             T dl = sqrt((dXdr*dXdr.Transpose())(0, 0));
 
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
 		
             Matrix<T> B = Matrix<T>(2, 2*m + n);
             for(int i = 0; i < m; i++){
@@ -197,11 +238,11 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Vector<T> N = SFP<T>::N(IC<T>::Points[g]);
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Vector<T>& N = ReferenceElement<T, SFP, IC>::N(g);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
 			Vector<T> x = Xp.Transpose()*N;
 			Vector<T> b = _f(x);
 
@@ -240,10 +281,10 @@ namespace PANSFEM2 {
 		}
 
 		for (int g = 0; g < IC<T>::N; g++) {
-			Matrix<T> dNdr = SFP<T>::dNdr(IC<T>::Points[g]);
+			const Matrix<T>& dNdr = ReferenceElement<T, SFP, IC>::dNdr(g);
 			Matrix<T> dXdr = dNdr*Xp;
 			T J = dXdr.Determinant();
-			Vector<T> M = SFU<T>::N(IC<T>::Points[g]);
+			const Vector<T>& M = ReferenceElement<T, SFU, IC>::N(g);
 
             Matrix<T> K = Matrix<T>(2*m + n, 2*m + n);
             for(int i = 0; i < m; i++) {
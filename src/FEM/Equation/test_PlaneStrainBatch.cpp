@@ -0,0 +1,60 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+
+#include "PlaneStrain.h"
+#include "../Controller/ShapeFunction.h"
+#include "../Controller/GaussIntegration.h"
+#include "../../PrePost/Mesher/SquareMesh.h"
+
+
+using namespace PANSFEM2;
+
+
+template<template<class>class SF, template<class>class IC>
+double MaxError(std::vector<Vector<double> >& _x, const std::vector<std::vector<int> >& _elements, int _begin, int _end) {
+    std::vector<Matrix<double> > Kes;
+    std::vector<std::vector<std::pair<int, int> > > nodetoelementbatch;
+    PlaneStrainStiffnessBatch<double, SF, IC>(Kes, nodetoelementbatch, _elements, _begin, _end, { 0, 1 }, _x, 210000.0, 0.3, 1.0);
+
+    double error = 0.0;
+    for(int i = _begin; i < _end; i++){
+        Matrix<double> Ke;
+        std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+        PlaneStrainStiffness<double, SF, IC>(Ke, nodetoelement, _elements[i], { 0, 1 }, _x, 210000.0, 0.3, 1.0);
+        for(int p = 0; p < Ke.ROW(); p++){
+            for(int q = 0; q < Ke.COL(); q++){
+                error = std::max(error, fabs(Kes[i - _begin](p, q) - Ke(p, q))/210000.0);
+            }
+        }
+        if(nodetoelement != nodetoelementbatch){
+            error = INFINITY;
+        }
+    }
+    return error;
+}
+
+
+int main(){
+    //----------Distorted quadrilateral mesh, number of elements is not a multiple of batch width----------
+    SquareMesh<double> mesh = SquareMesh<double>(5.0, 3.0, 5, 3);
+    std::vector<Vector<double> > x = mesh.GenerateNodes();
+    std::vector<std::vector<int> > elements = mesh.GenerateElements();
+    for(int i = 0; i < x.size(); i++){
+        x[i](0) += 0.2*sin(1.7*i);
+        x[i](1) += 0.2*cos(2.3*i);
+    }
+    std::cout << "Quadrilateral [0, " << elements.size() << ") error = " << MaxError<ShapeFunction4Square, Gauss4Square>(x, elements, 0, elements.size()) << std::endl;
+    std::cout << "Quadrilateral [3, 12) error = " << MaxError<ShapeFunction4Square, Gauss4Square>(x, elements, 3, 12) << std::endl;
+
+    //----------Triangles made by splitting quadrilaterals----------
+    std::vector<std::vector<int> > triangles;
+    for(auto& element : elements){
+        triangles.push_back({ element[0], element[1], element[2] });
+        triangles.push_back({ element[0], element[2], element[3] });
+    }
+    std::cout << "Triangle [0, " << triangles.size() << ") error = " << MaxError<ShapeFunction3Triangle, Gauss1Triangle>(x, triangles, 0, triangles.size()) << std::endl;
+
+    return 0;
+}
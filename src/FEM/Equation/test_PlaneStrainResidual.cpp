@@ -0,0 +1,45 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+
+#include "PlaneStrain.h"
+#include "../Controller/ShapeFunction.h"
+#include "../Controller/GaussIntegration.h"
+
+
+using namespace PANSFEM2;
+
+
+double MaxError(const Vector<double>& _Fe0, const Vector<double>& _Fe1) {
+    double error = 0.0, norm = 0.0;
+    for(int p = 0; p < _Fe0.SIZE(); p++){
+        error = std::max(error, fabs(_Fe0(p) - _Fe1(p)));
+        norm = std::max(norm, fabs(_Fe0(p)));
+    }
+    return error/norm;
+}
+
+
+int main(){
+    //----------Distorted quadrilateral with large deformation----------
+    std::vector<Vector<double> > x = { { 0.0, 0.0 }, { 1.2, 0.1 }, { 1.0, 0.9 }, { -0.1, 1.1 } };
+    std::vector<Vector<double> > u = { { 0.0, 0.0 }, { 0.15, -0.05 }, { 0.2, 0.1 }, { -0.05, 0.12 } };
+    std::vector<int> element = { 0, 1, 2, 3 };
+    double E = 210000.0, V = 0.3, t = 1.0;
+
+    //----------TotalLagrange----------
+    Matrix<double> Ke;
+    Vector<double> Fe, Re;
+    std::vector<std::vector<std::pair<int, int> > > nodetoelement, nodetoelementresidual;
+    PlaneStrainStiffnessTotalLagrange<double, ShapeFunction4Square, Gauss4Square>(Ke, Fe, nodetoelement, element, { 0, 1 }, x, u, E, V, t);
+    PlaneStrainTotalLagrangeResidual<double, ShapeFunction4Square, Gauss4Square>(Re, nodetoelementresidual, element, { 0, 1 }, x, u, E, V, t);
+    std::cout << "TotalLagrange error = " << (nodetoelement == nodetoelementresidual ? MaxError(Fe, Re) : INFINITY) << std::endl;
+
+    //----------UpdatedLagrange----------
+    PlaneStrainStiffnessUpdatedLagrange<double, ShapeFunction4Square, Gauss4Square>(Ke, Fe, nodetoelement, element, { 0, 1 }, x, u, E, V, t);
+    PlaneStrainUpdatedLagrangeResidual<double, ShapeFunction4Square, Gauss4Square>(Re, nodetoelementresidual, element, { 0, 1 }, x, u, E, V, t);
+    std::cout << "UpdatedLagrange error = " << (nodetoelement == nodetoelementresidual ? MaxError(Fe, Re) : INFINITY) << std::endl;
+
+    return 0;
+}
@@ -31,11 +31,14 @@ public:
 	CSR(LILCSR<T>& _matrix);	//	Convert from LILCSR to CSR
 
 
-	const int ROWS;				//	Row number
-	const int COLS;				//	Column number
+	int ROWS;					//	Row number
+	int COLS;					//	Column number
 
 
 	const std::vector<T> operator*(const std::vector<T> &_vec);					//	Multiple with vector
+	void multiply(const std::vector<T> &_vec, std::vector<T> &_result);		//	Multiple with vector into _result without allocation
+	void multiply(const std::vector<T> &_vecs, std::vector<T> &_results, int _k);	//	Multiple with _k vectors interleaved as _vecs[i*_k + j] into _results
+	void multiplyTranspose(const std::vector<T> &_vec, std::vector<T> &_result);	//	Multiple transposed matrix with vector into _result without transposing
 
 
 	template<class T1, class T2>
@@ -56,11 +59,19 @@ public:
 	T get(int _row, int _col) const;			//	Get value at _row, _col
 
 
+	template<class F>
+	friend CSR<F> SubMatrix(const CSR<F>& _A, int _rowbegin, int _rowend, int _colbegin, int _colend);	//	Get block [_rowbegin, _rowend) x [_colbegin, _colend)
+	template<class F>
+	friend CSR<F> Transpose(const CSR<F>& _A);	//	Get transposed matrix
 	template<class F>
 	friend CSR<F> ILU0(CSR<F>& _A);				//	Incomplete LU(0) decomposition
 	template<class F>
 	friend std::vector<F> PreILU0(CSR<F> &_A, std::vector<F> &_b);		//	Apply incomplete LU(0) decomposition 
 	template<class F>
+	friend void PreILU0(CSR<F> &_A, const std::vector<F> &_b, std::vector<F> &_x);	//	Apply incomplete LU(0) decomposition into _x
+	template<class F>
+	friend void PreILU0Transpose(CSR<F> &_A, const std::vector<F> &_b, std::vector<F> &_x);	//	Apply transposed incomplete LU(0) decomposition into _x
+	template<class F>
 	friend std::vector<F> SOR(CSR<F> &_A, std::vector<F> &_b, F _w, int _itrmax, F _eps);	//	Solve with SOR
 
 
@@ -108,17 +119,61 @@ inline CSR<T>::CSR(LILCSR<T>& _matrix) : ROWS(_matrix.ROWS), COLS(_matrix.COLS)
 template<class T>
 inline const std::vector<T> CSR<T>::operator*(const std::vector<T> &_vec) {
 	std::vector<T> v(this->ROWS, T());
+	this->multiply(_vec, v);
+	return v;
+}
+
+
+template<class T>
+inline void CSR<T>::multiply(const std::vector<T> &_vec, std::vector<T> &_result) {
+	_result.resize(this->ROWS);
 
 	int iend = this->ROWS;
 
 #pragma omp parallel for
 	for (int i = 0; i < iend; ++i) {
+		T vi = T();
 		for (int j = this->indptr[i], jend = this->indptr[i + 1]; j < jend; ++j) {
-			v[i] += this->data[j] * _vec[this->indices[j]];
+			vi += this->data[j] * _vec[this->indices[j]];
 		}
+		_result[i] = vi;
 	}
+}
 
-	return v;
+
+template<class T>
+inline void CSR<T>::multiply(const std::vector<T> &_vecs, std::vector<T> &_results, int _k) {
+	_results.resize(this->ROWS*_k);
+
+	int iend = this->ROWS;
+
+#pragma omp parallel for
+	for (int i = 0; i < iend; ++i) {
+		T* resulti = &_results[i*_k];
+		for (int l = 0; l < _k; ++l) {
+			resulti[l] = T();
+		}
+		for (int j = this->indptr[i], jend = this->indptr[i + 1]; j < jend; ++j) {
+			T dataj = this->data[j];
+			const T* vecj = &_vecs[this->indices[j]*_k];
+#pragma omp simd
+			for (int l = 0; l < _k; ++l) {
+				resulti[l] += dataj * vecj[l];
+			}
+		}
+	}
+}
+
+
+template<class T>
+inline void CSR<T>::multiplyTranspose(const std::vector<T> &_vec, std::vector<T> &_result) {
+	_result = std::vector<T>(this->COLS, T());
+	for (int i = 0; i < this->ROWS; ++i) {
+		T veci = _vec[i];
+		for (int j = this->indptr[i], jend = this->indptr[i + 1]; j < jend; ++j) {
+			_result[this->indices[j]] += this->data[j] * veci;
+		}
+	}
 }
 
 
@@ -167,6 +222,50 @@ inline T CSR<T>::get(int _row, int _col) const {
 }
 
 
+template<class F>
+inline CSR<F> SubMatrix(const CSR<F>& _A, int _rowbegin, int _rowend, int _colbegin, int _colend) {
+	assert(0 <= _rowbegin && _rowbegin <= _rowend && _rowend <= _A.ROWS && 0 <= _colbegin && _colbegin <= _colend && _colend <= _A.COLS);
+
+	CSR<F> m = CSR<F>(_rowend - _rowbegin, _colend - _colbegin);
+	for (int i = _rowbegin; i < _rowend; i++) {
+		auto colbegin = std::lower_bound(_A.indices.begin() + _A.indptr[i], _A.indices.begin() + _A.indptr[i + 1], _colbegin);
+		for (auto k = colbegin; k != _A.indices.begin() + _A.indptr[i + 1] && *k < _colend; ++k) {
+			m.indices.push_back(*k - _colbegin);
+			m.data.push_back(_A.data[std::distance(_A.indices.begin(), k)]);
+		}
+		m.indptr[i - _rowbegin + 1] = m.indices.size();
+	}
+
+	return m;
+}
+
+
+template<class F>
+inline CSR<F> Transpose(const CSR<F>& _A) {
+	CSR<F> m = CSR<F>(_A.COLS, _A.ROWS);
+
+	//	Count entries in each column and scatter rows in ascending order
+	for (int k = 0; k < _A.indptr[_A.ROWS]; k++) {
+		m.indptr[_A.indices[k] + 1]++;
+	}
+	for (int j = 0; j < _A.COLS; j++) {
+		m.indptr[j + 1] += m.indptr[j];
+	}
+	m.indices = std::vector<int>(_A.indptr[_A.ROWS]);
+	m.data = std::vector<F>(_A.indptr[_A.ROWS]);
+	std::vector<int> next = std::vector<int>(m.indptr.begin(), m.indptr.end() - 1);
+	for (int i = 0; i < _A.ROWS; i++) {
+		for (int k = _A.indptr[i]; k < _A.indptr[i + 1]; k++) {
+			int kt = next[_A.indices[k]]++;
+			m.indices[kt] = i;
+			m.data[kt] = _A.data[k];
+		}
+	}
+
+	return m;
+}
+
+
 template<class F>
 inline CSR<F> operator*(F _a, const CSR<F>& _m) {
 	CSR<F> m = CSR<F>(_m);
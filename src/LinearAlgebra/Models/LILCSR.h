@@ -30,8 +30,8 @@ public:
 	LILCSR(CSR<T> _matrix);			//Genarate LILCSR matrix from CSR matrix
 
 
-	const int ROWS;					//Row number
-	const int COLS;					//Column number
+	int ROWS;						//Row number
+	int COLS;						//Column number
 
 
 	template<class T1, class T2>
@@ -52,6 +52,7 @@ public:
 
 	bool set(int _row, int _col, T _data);	//Set value
 	T get(int _row, int _col) const;		//Get value
+	void add(const LILCSR<T>& _m, int _rowbegin, int _rowend);	//Add rows [_rowbegin, _rowend) of _m
 
 
 	template<class F>
@@ -114,6 +115,17 @@ inline T LILCSR<T>::get(int _row, int _col) const {
 }
 
 
+template<class T>
+inline void LILCSR<T>::add(const LILCSR<T>& _m, int _rowbegin, int _rowend) {
+	assert(this->ROWS == _m.ROWS && this->COLS == _m.COLS && 0 <= _rowbegin && _rowbegin <= _rowend && _rowend <= this->ROWS);
+	for (int i = _rowbegin; i < _rowend; i++) {
+		for (const auto& dataij : _m.data[i]) {
+			this->set(i, dataij.first, this->get(i, dataij.first) + dataij.second);
+		}
+	}
+}
+
+
 template<class T1, class T2>
 inline const std::vector<T1> operator*(const LILCSR<T1>& _m, const std::vector<T2>& _vec) {
 	assert(_m.COLS == _vec.size());
@@ -10,6 +10,7 @@
 #include <cmath>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 
 
 #include "Vector.h"
@@ -20,6 +21,9 @@ namespace PANSFEM2{
     class Vector;
 
 
+    const int MATRIXBLOCKSIZE = 64;     //Block size of cache blocking in matrix product
+
+
     template<class T>
     class Matrix{
 public:
@@ -33,6 +37,7 @@ public:
         int ROW() const;
         int COL() const;
         T& operator()(int _i, int _j);
+        const T& operator()(int _i, int _j) const;
 
 
         Matrix<T>& operator=(const Matrix<T>& _mat);
@@ -42,32 +47,32 @@ public:
         Matrix<T>& operator/=(T _a);
 
 
-        Matrix<T> operator+(const Matrix<T>& _mat);
-        Matrix<T> operator-(const Matrix<T>& _mat);
-        Matrix<T> operator-();
-        Matrix<T> operator*(const Matrix<T>& _mat);
-        Vector<T> operator*(const Vector<T>& _vec);
-        Matrix<T> operator*(T _a);
-        Matrix<T> operator/(T _a);
+        Matrix<T> operator+(const Matrix<T>& _mat) const;
+        Matrix<T> operator-(const Matrix<T>& _mat) const;
+        Matrix<T> operator-() const;
+        Matrix<T> operator*(const Matrix<T>& _mat) const;
+        Vector<T> operator*(const Vector<T>& _vec) const;
+        Matrix<T> operator*(T _a) const;
+        Matrix<T> operator/(T _a) const;
 
 
         template<class U>
 	    friend std::ostream& operator << (std::ostream& _out, const Matrix<U>& _mat);
         
 
-        Matrix<T> Transpose();
-        T Determinant();
-        Matrix<T> Inverse();
-        Matrix<T> Cofactor(int _i, int _j);
-        Matrix<T> Vstack(const Matrix<T>& _mat);
-        Matrix<T> Hstack(const Matrix<T>& _mat);
-        Matrix<T> Block(int _row, int _col, int _h, int _w);
+        Matrix<T> Transpose() const;
+        T Determinant() const;
+        Matrix<T> Inverse() const;
+        Matrix<T> Cofactor(int _i, int _j) const;
+        Matrix<T> Vstack(const Matrix<T>& _mat) const;
+        Matrix<T> Hstack(const Matrix<T>& _mat) const;
+        Matrix<T> Block(int _row, int _col, int _h, int _w) const;
 
 
         template<class U>
-        friend Matrix<U> Vector<U>::Transpose();
+        friend Matrix<U> Vector<U>::Transpose() const;
         template<class U>
-        friend Matrix<U> Vector<U>::operator*(const Matrix<U>& _mat);
+        friend Matrix<U> Vector<U>::operator*(const Matrix<U>& _mat) const;
         template<class U>
         friend Matrix<U> operator*(U _a, const Matrix<U>& _mat);
 
@@ -76,6 +81,10 @@ public:
         friend Matrix<U> Identity(int _row);
         template<class U>
         friend Matrix<U> Diagonal(const Vector<U>& _vec);
+        template<class U>
+        friend Matrix<U> AtB(const Matrix<U>& _A, const Matrix<U>& _B);
+        template<class U>
+        friend void AddBtDB(Matrix<U>& _Ke, const Matrix<U>& _B, const Matrix<U>& _D, U _scale);
 
 
         template<class F>
@@ -93,6 +102,7 @@ protected:
     Matrix<T>::Matrix() {
         this->row = 0;
         this->col = 0;
+        this->values = nullptr;
     }
 
 
@@ -151,6 +161,13 @@ protected:
     }
 
 
+    template<class T>
+    const T& Matrix<T>::operator()(int _i, int _j) const {
+        assert(0 <= _i && _i < this->row && 0 <= _j && _j < this->col);
+        return this->values[_i * this->col + _j];
+    }
+
+
     template<class T>
     Matrix<T>& Matrix<T>::operator=(const Matrix<T>& _mat){
         if(this != &_mat){
@@ -208,7 +225,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::operator+(const Matrix<T>& _mat){
+    Matrix<T> Matrix<T>::operator+(const Matrix<T>& _mat) const {
         assert(this->row == _mat.row && this->col == _mat.col);
         Matrix<T> mat = *this;
         for(int i = 0; i < mat.row * mat.col; i++){
@@ -219,7 +236,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::operator-(const Matrix<T>& _mat){
+    Matrix<T> Matrix<T>::operator-(const Matrix<T>& _mat) const {
         assert(this->row == _mat.row && this->col == _mat.col);
         Matrix<T> mat = *this;
         for(int i = 0; i < mat.row * mat.col; i++){
@@ -230,7 +247,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::operator-(){
+    Matrix<T> Matrix<T>::operator-() const {
         Matrix<T> mat = *this;
         for(int i = 0; i < mat.row * mat.col; i++){
             mat.values[i] *= -1.0;
@@ -240,14 +257,23 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::operator*(const Matrix<T>& _mat){
+    Matrix<T> Matrix<T>::operator*(const Matrix<T>& _mat) const {
         assert(this->col == _mat.row);
         Matrix<T> mat = Matrix<T>(this->row, _mat.col);
-        for(int i = 0; i < mat.row; i++){
-            for(int j = 0; j < mat.col; j++){
-                mat.values[i * mat.col + j] = T();
-                for(int k = 0; k < this->col; k++){
-                    mat.values[i * mat.col + j] += this->values[i * this->col + k] * _mat.values[k * _mat.col + j];
+        for(int kk = 0; kk < this->col; kk += MATRIXBLOCKSIZE){
+            int kmax = std::min(kk + MATRIXBLOCKSIZE, this->col);
+            for(int jj = 0; jj < mat.col; jj += MATRIXBLOCKSIZE){
+                int jmax = std::min(jj + MATRIXBLOCKSIZE, mat.col);
+                for(int i = 0; i < mat.row; i++){
+                    T* mati = &mat.values[i * mat.col];
+                    for(int k = kk; k < kmax; k++){
+                        T aik = this->values[i * this->col + k];
+                        const T* matk = &_mat.values[k * _mat.col];
+#pragma omp simd
+                        for(int j = jj; j < jmax; j++){
+                            mati[j] += aik * matk[j];
+                        }
+                    }
                 }
             }
         }
@@ -256,7 +282,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Matrix<T>::operator*(const Vector<T>& _vec){
+    Vector<T> Matrix<T>::operator*(const Vector<T>& _vec) const {
         assert(this->col == _vec.size);
         Vector<T> v = Vector<T>(this->row);
         for(int i = 0; i < this->row; i++){
@@ -269,7 +295,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::operator*(T _a){
+    Matrix<T> Matrix<T>::operator*(T _a) const {
         Matrix<T> mat = *this;
         for(int i = 0; i < mat.row * mat.col; i++){
             mat.values[i] *= _a;
@@ -279,7 +305,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::operator/(T _a){
+    Matrix<T> Matrix<T>::operator/(T _a) const {
         Matrix<T> mat = *this;
         for(int i = 0; i < mat.row * mat.col; i++){
             mat.values[i] /= _a;
@@ -311,7 +337,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::Transpose(){
+    Matrix<T> Matrix<T>::Transpose() const {
         Matrix<T> mat = Matrix<T>(this->col, this->row);
         for(int i = 0; i < mat.row; i++){
             for(int j = 0; j < mat.col; j++){
@@ -323,7 +349,7 @@ protected:
 
 
     template<class T>
-    T Matrix<T>::Determinant(){
+    T Matrix<T>::Determinant() const {
         assert(this->row == this->col && this->row != 0);
         if(this->row == 1) {
             return this->values[0];
@@ -343,7 +369,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::Inverse(){
+    Matrix<T> Matrix<T>::Inverse() const {
         assert(this->row == this->col);
         Matrix<T> mat = Matrix<T>(this->row, this->col);
         if(this->row == 1){
@@ -361,7 +387,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::Cofactor(int _i, int _j){
+    Matrix<T> Matrix<T>::Cofactor(int _i, int _j) const {
         assert(0 <= _i && _i < this->row && 0 <= _j && _j < this->col);
         Matrix<T> mat = Matrix<T>(this->row - 1, this->col - 1);
         for(int i = 0; i < mat.row; i++){
@@ -386,7 +412,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::Vstack(const Matrix<T>& _mat){
+    Matrix<T> Matrix<T>::Vstack(const Matrix<T>& _mat) const {
         assert(this->col == _mat.col);
         Matrix<T> mat = Matrix<T>(this->row + _mat.row, this->col);
         for(int i = 0; i < this->row; i++){
@@ -404,7 +430,7 @@ protected:
     
     
     template<class T>
-    Matrix<T> Matrix<T>::Hstack(const Matrix<T>& _mat){
+    Matrix<T> Matrix<T>::Hstack(const Matrix<T>& _mat) const {
         assert(this->row == _mat.row);
         Matrix<T> mat = Matrix<T>(this->row, this->col + _mat.col);
         for(int i = 0; i < this->row; i++){
@@ -422,7 +448,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Matrix<T>::Block(int _row, int _col, int _h, int _w){
+    Matrix<T> Matrix<T>::Block(int _row, int _col, int _h, int _w) const {
         assert(_row >= 0 && _col >= 0 && _h > 0 && _w > 0 && _row + _h <= this->row && _col + _w <= this->col);
 
         Matrix<T> m = Matrix<T>(_h, _w);
@@ -453,4 +479,60 @@ protected:
         }
         return mat;
     }
+
+
+    //  Return A^T*B without making transpose of A
+    template<class U>
+    Matrix<U> AtB(const Matrix<U>& _A, const Matrix<U>& _B){
+        assert(_A.row == _B.row);
+        Matrix<U> mat = Matrix<U>(_A.col, _B.col);
+        for(int k = 0; k < _A.row; k++){
+            const U* Bk = &_B.values[k * _B.col];
+            for(int i = 0; i < _A.col; i++){
+                U aki = _A.values[k * _A.col + i];
+                if(aki != U()){
+                    U* mati = &mat.values[i * mat.col];
+#pragma omp simd
+                    for(int j = 0; j < mat.col; j++){
+                        mati[j] += aki * Bk[j];
+                    }
+                }
+            }
+        }
+        return mat;
+    }
+
+
+    //  Add _scale*B^T*D*B to Ke without temporaries of B^T and B^T*D
+    template<class U>
+    void AddBtDB(Matrix<U>& _Ke, const Matrix<U>& _B, const Matrix<U>& _D, U _scale){
+        assert(_D.row == _D.col && _D.col == _B.row && _Ke.row == _B.col && _Ke.col == _B.col);
+        Matrix<U> DB = Matrix<U>(_D.row, _B.col);
+        for(int i = 0; i < _D.row; i++){
+            U* DBi = &DB.values[i * DB.col];
+            for(int k = 0; k < _D.col; k++){
+                U dik = _scale * _D.values[i * _D.col + k];
+                if(dik != U()){
+                    const U* Bk = &_B.values[k * _B.col];
+#pragma omp simd
+                    for(int j = 0; j < _B.col; j++){
+                        DBi[j] += dik * Bk[j];
+                    }
+                }
+            }
+        }
+        for(int k = 0; k < _B.row; k++){
+            const U* DBk = &DB.values[k * DB.col];
+            for(int i = 0; i < _B.col; i++){
+                U bki = _B.values[k * _B.col + i];
+                if(bki != U()){
+                    U* Kei = &_Ke.values[i * _Ke.col];
+#pragma omp simd
+                    for(int j = 0; j < _Ke.col; j++){
+                        Kei[j] += bki * DBk[j];
+                    }
+                }
+            }
+        }
+    }
 }
\ No newline at end of file
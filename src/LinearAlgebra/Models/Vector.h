@@ -35,6 +35,7 @@ public:
 
         int SIZE() const;
         T& operator()(int _i);
+        const T& operator()(int _i) const;
 
 
         Vector<T>& operator=(const Vector<T>& _vec);
@@ -44,13 +45,13 @@ public:
         Vector<T>& operator/=(T _a);
 
 
-        Vector<T> operator+(const Vector<T>& _vec);
-        Vector<T> operator-(const Vector<T>& _vec);
-        Vector<T> operator-();
-        T operator*(const Vector<T>& _vec);
-        Matrix<T> operator*(const Matrix<T>& _mat);
-        Vector<T> operator*(T _a);
-        Vector<T> operator/(T _a);
+        Vector<T> operator+(const Vector<T>& _vec) const;
+        Vector<T> operator-(const Vector<T>& _vec) const;
+        Vector<T> operator-() const;
+        T operator*(const Vector<T>& _vec) const;
+        Matrix<T> operator*(const Matrix<T>& _mat) const;
+        Vector<T> operator*(T _a) const;
+        Vector<T> operator/(T _a) const;
 
 
         template<class U>
@@ -63,11 +64,11 @@ public:
         friend Vector<U> VectorProduct(Vector<U> _vec0, Vector<U> _vec1);
 
 
-        T Norm();
-        Matrix<T> Transpose();
-        Vector<T> Vstack(const Vector<T>& _vec);
-        Vector<T> Segment(int _head, int _tail);
-        Vector<T> Normal();
+        T Norm() const;
+        Matrix<T> Transpose() const;
+        Vector<T> Vstack(const Vector<T>& _vec) const;
+        Vector<T> Segment(int _head, int _tail) const;
+        Vector<T> Normal() const;
 
 
         template<class F>
@@ -83,6 +84,7 @@ protected:
     template<class T>
     Vector<T>::Vector(){
         this->size = 0;
+        this->values = nullptr;
     }
 
 
@@ -153,6 +155,13 @@ protected:
     }
 
 
+    template<class T>
+    const T& Vector<T>::operator()(int _i) const {
+        assert(0 <= _i && _i < this->size);
+        return this->values[_i];
+    }
+
+
     template<class T>
     Vector<T>& Vector<T>::operator=(const Vector<T>& _vec){
         if(this != &_vec){
@@ -209,7 +218,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::operator+(const Vector<T>& _vec){
+    Vector<T> Vector<T>::operator+(const Vector<T>& _vec) const {
         assert(this->size == _vec.size);
         Vector<T> vec = *this;
         for(int i = 0; i < vec.size; i++){
@@ -220,7 +229,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::operator-(const Vector<T>& _vec){
+    Vector<T> Vector<T>::operator-(const Vector<T>& _vec) const {
         assert(this->size == _vec.size);
         Vector<T> vec = *this;
         for(int i = 0; i < vec.size; i++){
@@ -231,7 +240,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::operator-(){
+    Vector<T> Vector<T>::operator-() const {
         Vector<T> vec = *this;
         for(int i = 0; i < vec.size; i++){
             vec.values[i] *= -1;
@@ -241,7 +250,7 @@ protected:
 
 
     template<class T>
-    T Vector<T>::operator*(const Vector<T>& _vec){
+    T Vector<T>::operator*(const Vector<T>& _vec) const {
         assert(this->size == _vec.size);
         T value = T();
         for(int i = 0; i < this->size; i++){
@@ -252,7 +261,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Vector<T>::operator*(const Matrix<T>& _mat){
+    Matrix<T> Vector<T>::operator*(const Matrix<T>& _mat) const {
         assert(_mat.row == 1);
         Matrix<T> mat = Matrix<T>(this->size, _mat.col);
         for(int i = 0; i < mat.row; i++){
@@ -265,7 +274,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::operator*(T _a){
+    Vector<T> Vector<T>::operator*(T _a) const {
         Vector<T> vec = *this;
         for(int i = 0; i < vec.size; i++){
             vec.values[i] *= _a;
@@ -275,7 +284,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::operator/(T _a){
+    Vector<T> Vector<T>::operator/(T _a) const {
         Vector<T> vec = *this;
         for(int i = 0; i < vec.size; i++){
             vec.values[i] /= _a;
@@ -294,7 +303,7 @@ protected:
 
 
     template<class T>
-    T Vector<T>::Norm(){
+    T Vector<T>::Norm() const {
         T value = T();
         for(int i = 0; i < this->size; i++){
             value += pow(this->values[i], 2.0);
@@ -304,7 +313,7 @@ protected:
 
 
     template<class T>
-    Matrix<T> Vector<T>::Transpose(){
+    Matrix<T> Vector<T>::Transpose() const {
         Matrix<T> mat = Matrix<T>(1, this->size);
         for(int i = 0; i < mat.row * mat.col; i++){
             mat.values[i] = this->values[i];
@@ -314,7 +323,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::Vstack(const Vector<T>& _vec){
+    Vector<T> Vector<T>::Vstack(const Vector<T>& _vec) const {
         Vector<T> vec = Vector<T>(this->size + _vec.size);
         for(int i = 0; i < this->size; i++){
             vec.values[i] = this->values[i];
@@ -327,7 +336,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::Segment(int _head, int _tail){
+    Vector<T> Vector<T>::Segment(int _head, int _tail) const {
         assert(_head >= 0 && _tail <= this->size && _head < _tail);
         Vector<T> vec = Vector<T>(_tail - _head);
         for(int i = 0; i < vec.size; i++){
@@ -338,7 +347,7 @@ protected:
 
 
     template<class T>
-    Vector<T> Vector<T>::Normal(){
+    Vector<T> Vector<T>::Normal() const {
         Vector<T> v = *this;
         return v/v.Norm();
     }
@@ -0,0 +1,104 @@
+//*****************************************************************************
+//Title		:LinearAlgebra/Solvers/BlockPreconditioner.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/19
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cassert>
+
+
+#include "../Models/CSR.h"
+#include "CG.h"
+#include "GMRES.h"
+
+
+//********************Block upper triangular preconditioner for saddle point system********************
+//	K = [A B1; B2 C] with velocity dofs [0, _nu) and pressure dofs [_nu, n), which is given by
+//	Renumbering with { { 0, 1 }, { 2 } }. Preconditioner is P = [A B1; 0 S] with
+//	approximation S of Schur complement C - B2*A^-1*B1, e.g. pressure mass matrix scaled by -1/mu
+//	for StokesStiffness and by 1/mu for NavierStokesStiffness with ContinuityStiffness.
+//	A^-1 is ILU(0) preconditioning GMRES with at most _itrmax iterations to _eps, which keeps
+//	outer iterations almost independent of mesh size. P is variable then, so use it with FGMRES.
+//	_itrmax = 0 gives one ILU(0) sweep, which is fixed but depends on mesh size.
+template<class T>
+class BlockTriangularPreconditioner {
+public:
+	BlockTriangularPreconditioner();
+	BlockTriangularPreconditioner(CSR<T>& _K, int _nu, CSR<T>& _S, int _itrmax = 10, T _eps = 1.0e-1);
+
+
+	void operator()(const std::vector<T>& _r, std::vector<T>& _z);		//	Apply P^-1 to _r
+
+
+	bool ISFLEXIBLE() const;		//	P changes in each application or not
+
+
+private:
+	int nu, np;
+	CSR<T> A, B1, MA, MS;			//	Velocity block, coupling block, ILU(0) of A and S
+	int itrmax;
+	T eps;
+	GMRESWorkspace<T> work;
+	std::vector<T> ru, zu, zp, w;
+};
+
+
+template<class T>
+inline BlockTriangularPreconditioner<T>::BlockTriangularPreconditioner() : nu(0), np(0), itrmax(0), eps(T()) {}
+
+
+template<class T>
+inline BlockTriangularPreconditioner<T>::BlockTriangularPreconditioner(CSR<T>& _K, int _nu, CSR<T>& _S, int _itrmax, T _eps) {
+	assert(_K.ROWS == _K.COLS && 0 < _nu && _nu < _K.ROWS);
+	assert(_S.ROWS == _K.ROWS - _nu && _S.COLS == _K.ROWS - _nu);
+
+	this->nu = _nu;
+	this->np = _K.ROWS - _nu;
+	this->A = SubMatrix(_K, 0, this->nu, 0, this->nu);
+	this->B1 = SubMatrix(_K, 0, this->nu, this->nu, _K.COLS);
+	this->MA = ILU0(this->A);
+	this->MS = ILU0(_S);
+	this->itrmax = _itrmax;
+	this->eps = _eps;
+	if (this->itrmax > 0) {
+		this->work = GMRESWorkspace<T>(this->nu, this->itrmax);
+		this->work.isverbose = false;
+	}
+	this->ru = std::vector<T>(this->nu);
+	this->zu = std::vector<T>(this->nu);
+	this->zp = std::vector<T>(this->np);
+	this->w = std::vector<T>(this->np);
+}
+
+
+template<class T>
+inline void BlockTriangularPreconditioner<T>::operator()(const std::vector<T>& _r, std::vector<T>& _z) {
+	//----------Pressure : zp = S^-1*rp----------
+	std::copy(_r.begin() + this->nu, _r.end(), this->w.begin());
+	PreILU0(this->MS, this->w, this->zp);
+
+	//----------Velocity : zu = A^-1*(ru - B1*zp)----------
+	this->B1.multiply(this->zp, this->ru);
+	for (int i = 0; i < this->nu; i++) {
+		this->ru[i] = _r[i] - this->ru[i];
+	}
+	if (this->itrmax == 0) {
+		PreILU0(this->MA, this->ru, this->zu);
+	} else {
+		std::fill(this->zu.begin(), this->zu.end(), T());
+		GMRES([&](const std::vector<T>& _v, std::vector<T>& _Av) { this->A.multiply(_v, _Av); }, [&](const std::vector<T>& _v, std::vector<T>& _Mv) { PreILU0(this->MA, _v, _Mv); }, this->ru, this->zu, this->itrmax, this->eps, this->work);
+	}
+
+	std::copy(this->zu.begin(), this->zu.end(), _z.begin());
+	std::copy(this->zp.begin(), this->zp.end(), _z.begin() + this->nu);
+}
+
+
+template<class T>
+inline bool BlockTriangularPreconditioner<T>::ISFLEXIBLE() const {
+	return this->itrmax > 0;
+}
@@ -120,15 +120,21 @@ inline std::vector<T> zeavpbwpcxpdy(T _a, const std::vector<T>& _v, T _b, const
 
 
 //********************CG method********************
+//	_x0 is initial guess such as previous solution, which is zero vector if empty. Same for all solvers below.
 template<class T>
-std::vector<T> CG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps) {
+std::vector<T> CG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Initialize----------
-	std::vector<T> xk(_b.size(), T());
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> pk = rk;
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 	T rkrk = std::inner_product(rk.begin(), rk.end(), rk.begin(), T());
 
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for (int k = 0; k < _itrmax; ++k) {
 		std::vector<T> Apk = _A*pk;
@@ -156,15 +162,20 @@ std::vector<T> CG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps) {
 
 //********************BiCGSTAB method********************
 template<class T>
-std::vector<T> BiCGSTAB(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps) {
+std::vector<T> BiCGSTAB(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Initialize----------
-	std::vector<T> xk(_b.size(), T());
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> rdash = rk;
 	std::vector<T> pk = rk;
 	T rdashrk = std::inner_product(rdash.begin(), rdash.end(), rk.begin(), T());
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for (int k = 0; k < _itrmax; ++k) {
 		std::vector<T> Apk = _A*pk;
@@ -195,9 +206,9 @@ std::vector<T> BiCGSTAB(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps) {
 
 //********************BiCGSTAB2 method********************
 template<class T>
-std::vector<T> BiCGSTAB2(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps) {
+std::vector<T> BiCGSTAB2(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Initialize----------
-	std::vector<T> xk(_b.size(), T());
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> rdash = rk;
 	std::vector<T> pk(_b.size(), T());
@@ -209,6 +220,11 @@ std::vector<T> BiCGSTAB2(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps) {
 	T rdashrk = std::inner_product(rdash.begin(), rdash.end(), rk.begin(), T());
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for(int k = 0; k < _itrmax; k++) {
 		xeaxpbypcz(beta, pk, 1.0, rk, -beta, uk);
@@ -256,39 +272,50 @@ std::vector<T> BiCGSTAB2(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps) {
 //********************Incomplete LU(0) decomposition********************
 template<class T>
 CSR<T> ILU0(CSR<T>& _A) {
-	LILCSR<T> q = LILCSR<T>(_A);
-
-	for (int i = 0, iend = _A.ROWS; i < iend; i++) {
-		for (int n = _A.indptr[i], nend = _A.indptr[i + 1]; n < nend; n++) {
-			int j = _A.indices[n];
-			T qij = _A.data[n];
-			for (int k = 0, kend = _A.ROWS; k < kend; k++) {
-				if (std::binary_search(_A.indices.begin() + _A.indptr[i], _A.indices.begin() + _A.indptr[i + 1], k)) {
-					if (std::binary_search(_A.indices.begin() + _A.indptr[k], _A.indices.begin() + _A.indptr[k + 1], j)) {
-						if ((i <= j && k < i) || (i > j && k < j)) {
-							qij -= q.get(i, k)*q.get(k, j);
-						} else {
-							break;
-						}
-					}
+	CSR<T> q = _A;
+	std::vector<int> position(_A.COLS, -1);		//Position of column in current row or -1
+
+	for (int i = 0; i < _A.ROWS; i++) {
+		for (int n = q.indptr[i]; n < q.indptr[i + 1]; n++) {
+			position[q.indices[n]] = n;
+		}
+
+		//----------Eliminate with upper rows k < i in the pattern of row i----------
+		for (int n = q.indptr[i]; n < q.indptr[i + 1] && q.indices[n] < i; n++) {
+			int k = q.indices[n];
+			int kk = std::lower_bound(q.indices.begin() + q.indptr[k], q.indices.begin() + q.indptr[k + 1], k) - q.indices.begin();
+			q.data[n] /= q.data[kk];
+			for (int m = kk + 1; m < q.indptr[k + 1]; m++) {
+				if (position[q.indices[m]] != -1) {
+					q.data[position[q.indices[m]]] -= q.data[n]*q.data[m];
 				}
 			}
-			if (i > j) {
-				qij /= q.get(j, j);
-			}
-			q.set(i, j, qij);
+		}
+
+		for (int n = q.indptr[i]; n < q.indptr[i + 1]; n++) {
+			position[q.indices[n]] = -1;
 		}
 	}
 
-	return CSR<T>(q);
+	return q;
 }
 
 
 //********************Solve with ILU(0)*******************
 template<class T>
 std::vector<T> PreILU0(CSR<T>& _A, std::vector<T>& _b) {
+	std::vector<T> v;
+	PreILU0(_A, (const std::vector<T>&)_b, v);
+	return v;
+}
+
+
+//********************Solve with ILU(0) into _x*******************
+template<class T>
+void PreILU0(CSR<T>& _A, const std::vector<T>& _b, std::vector<T>& _x) {
 	//----------Solve Ly=b with ILU(0)----------
-	std::vector<T> v = std::vector<T>(_b);
+	std::vector<T>& v = _x;
+	v = _b;
 	for (int i = 0; i < _b.size(); i++) {
 		for (int k = _A.indptr[i]; k < _A.indptr[i + 1]; k++) {
 			if (_A.indices[k] < i) {
@@ -301,31 +328,60 @@ std::vector<T> PreILU0(CSR<T>& _A, std::vector<T>& _b) {
 
 	//----------Solve Ux=y with ILU(0)----------
 	for (int i = _b.size() - 1; i >= 0; i--) {
+		T vii = T();
 		for (int k = _A.indptr[i + 1] - 1; k >= _A.indptr[i]; k--) {
 			if (_A.indices[k] > i) {
 				v[i] -= _A.data[k] * v[_A.indices[k]];
 			} else {
+				vii = _A.indices[k] == i ? _A.data[k] : T();
 				break;
 			}
 		}
-		v[i] /= _A.get(i, i);
+		v[i] /= vii;
 	}
+}
 
-	return v;
+
+//********************Solve with transposed ILU(0) into _x*******************
+//	(LU)^T*x = b is solved column by column with ILU(0) decomposition _A itself, so no transposed copy is made.
+template<class T>
+void PreILU0Transpose(CSR<T>& _A, const std::vector<T>& _b, std::vector<T>& _x) {
+	//----------Solve U^Ty=b----------
+	std::vector<T>& v = _x;
+	v = _b;
+	for (int i = 0; i < _b.size(); i++) {
+		int kii = std::lower_bound(_A.indices.begin() + _A.indptr[i], _A.indices.begin() + _A.indptr[i + 1], i) - _A.indices.begin();
+		v[i] /= (kii < _A.indptr[i + 1] && _A.indices[kii] == i) ? _A.data[kii] : T();
+		for (int k = kii + 1; k < _A.indptr[i + 1]; k++) {
+			v[_A.indices[k]] -= _A.data[k] * v[i];
+		}
+	}
+
+	//----------Solve L^Tx=y----------
+	for (int i = _b.size() - 1; i >= 0; i--) {
+		for (int k = _A.indptr[i]; k < _A.indptr[i + 1] && _A.indices[k] < i; k++) {
+			v[_A.indices[k]] -= _A.data[k] * v[i];
+		}
+	}
 }
 
 
 //*******************ILU(0) preconditioning CG method********************
 template<class T>
-std::vector<T> ILU0CG(CSR<T>& _A, CSR<T>& _M, const std::vector<T>& _b, int _itrmax, T _eps) {
+std::vector<T> ILU0CG(CSR<T>& _A, CSR<T>& _M, const std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Initialize----------
-	std::vector<T> xk(_b.size(), T());
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> pk = PreILU0(_M, rk);				//Preconditioning
 	std::vector<T> Mrk = pk;							
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 	T Mrkrk = std::inner_product(Mrk.begin(), Mrk.end(), rk.begin(), T());
 	
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for (int k = 0; k < _itrmax; ++k) {
 		std::vector<T> Apk = _A*pk;
@@ -354,15 +410,20 @@ std::vector<T> ILU0CG(CSR<T>& _A, CSR<T>& _M, const std::vector<T>& _b, int _itr
 
 //*******************ILU(0) preconditioning BiCGSTAB method*******************
 template<class T>
-std::vector<T> ILU0BiCGSTAB(CSR<T>& _A, CSR<T>& _M, std::vector<T>& _b, int _itrmax, T _eps) {
+std::vector<T> ILU0BiCGSTAB(CSR<T>& _A, CSR<T>& _M, std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Iniialize----------
-	std::vector<T> xk(_b.size(), T());
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> rdash = rk;
 	std::vector<T> pk = rk;
 	T rdashrk = std::inner_product(rdash.begin(), rdash.end(), rk.begin(), T());
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for (int k = 0; k < _itrmax; ++k) {
 		std::vector<T> Mpk = PreILU0(_M, pk);		//Preconditioning
@@ -393,6 +454,55 @@ std::vector<T> ILU0BiCGSTAB(CSR<T>& _A, CSR<T>& _M, std::vector<T>& _b, int _itr
 }
 
 
+//*******************ILU(0) preconditioning BiCGSTAB method for A^T*x = b*******************
+//	Adjoint equations are solved with ILU(0) decomposition _M of forward matrix _A without refactorization or transposing.
+template<class T>
+std::vector<T> ILU0BiCGSTABTranspose(CSR<T>& _A, CSR<T>& _M, const std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
+	//----------Iniialize----------
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
+	std::vector<T> ATxk;
+	_A.multiplyTranspose(xk, ATxk);
+	std::vector<T> rk = subtract(_b, ATxk);
+	std::vector<T> rdash = rk;
+	std::vector<T> pk = rk;
+	std::vector<T> Mpk, Msk, AMpk, AMsk;
+	T rdashrk = std::inner_product(rdash.begin(), rdash.end(), rk.begin(), T());
+	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
+
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
+	//----------Iteration----------
+	for (int k = 0; k < _itrmax; ++k) {
+		PreILU0Transpose(_M, pk, Mpk);				//Preconditioning
+		_A.multiplyTranspose(Mpk, AMpk);
+		T alpha = rdashrk/std::inner_product(rdash.begin(), rdash.end(), AMpk.begin(), T());
+		std::vector<T> sk = zeaxpby(1.0, rk, -alpha, AMpk);
+		PreILU0Transpose(_M, sk, Msk);				//Preconditioning
+		_A.multiplyTranspose(Msk, AMsk);
+		T omega = std::inner_product(AMsk.begin(), AMsk.end(), sk.begin(), T())/std::inner_product(AMsk.begin(), AMsk.end(), AMsk.begin(), T());
+		xeaxpbypcz(1.0, xk, alpha, Mpk, omega, Msk);
+		rk = zeaxpby(1.0, sk, -omega, AMsk);
+		T rdashrkp1 = std::inner_product(rdash.begin(), rdash.end(), rk.begin(), T());
+		T beta = alpha/omega*rdashrkp1/rdashrk;
+		xeaxpbypcz(beta, pk, 1.0, rk, -beta*omega, AMpk);
+		rdashrk = rdashrkp1;
+
+		//----------Check convergence----------
+		T rnorm = sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T()));
+		if (rnorm < _eps*bnorm) {
+			std::cout << "\tConvergence:" << k << std::endl;
+			return xk;
+		}
+	}
+
+	std::cout << "\nConvergence:faild" << std::endl;
+	return xk;
+}
+
+
 //********************Get diagonal vector of matrix _A********************
 template<class T>
 std::vector<T> GetDiagonal(CSR<T>& _A) {
@@ -406,7 +516,7 @@ std::vector<T> GetDiagonal(CSR<T>& _A) {
 
 //********************Scaling matrix********************
 template<class T>
-std::vector<T> Scaling(std::vector<T>& _D, std::vector<T>& _b) {
+std::vector<T> Scaling(const std::vector<T>& _D, const std::vector<T>& _b) {
 	std::vector<T> v(_D.size());
 	for (int i = 0; i < _D.size(); i++) {
 		v[i] = _b[i] / _D[i];
@@ -417,16 +527,28 @@ std::vector<T> Scaling(std::vector<T>& _D, std::vector<T>& _b) {
 
 //********************Scaling preconditioning CG method********************
 template<class T>
-std::vector<T> ScalingCG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps) {
+std::vector<T> ScalingCG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
+	return ScalingCG(_A, GetDiagonal(_A), _b, _itrmax, _eps, _x0);
+}
+
+
+//********************Scaling preconditioning CG method with given diagonal of _A********************
+template<class T>
+std::vector<T> ScalingCG(CSR<T>& _A, const std::vector<T>& _D, const std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Initialize----------
-	std::vector<T> D = GetDiagonal(_A);				//Scaling A matrix
-	std::vector<T> xk(_b.size(), T());
+	const std::vector<T>& D = _D;					//Scaling A matrix
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> pk = Scaling(D, rk);				//Scaling rk
 	std::vector<T> Mrk = pk;
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 	T Mrkrk = std::inner_product(Mrk.begin(), Mrk.end(), rk.begin(), T());
 
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for (int k = 0; k < _itrmax; ++k) {
 		std::vector<T> Apk = _A*pk;
@@ -453,18 +575,143 @@ std::vector<T> ScalingCG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _e
 }
 
 
+//********************Scaling preconditioning CG method for multiple right hand sides********************
+//	CG iterations of all _B share one pass over _A per iteration with vectors interleaved as v[i*na + a].
+//	Converged right hand sides are removed so that the width na shrinks to unconverged ones.
+template<class T>
+std::vector<std::vector<T> > ScalingMultiCG(CSR<T>& _A, const std::vector<T>& _D, const std::vector<std::vector<T> >& _B, int _itrmax, T _eps, const std::vector<std::vector<T> >& _X0 = std::vector<std::vector<T> >()) {
+	//----------Initialize----------
+	int n = _D.size(), na = _B.size();
+	assert(_X0.empty() || _X0.size() == na);
+	std::vector<std::vector<T> > X = std::vector<std::vector<T> >(na, std::vector<T>(n));
+	std::vector<int> active = std::vector<int>(na);				//Index of right hand sides in work vectors
+	std::vector<T> xk(n*na), rk, pk(n*na), Apk;
+	for (int a = 0; a < na; a++) {
+		assert(_B[a].size() == n);
+		active[a] = a;
+		for (int i = 0; i < n; i++) {
+			xk[i*na + a] = _X0.empty() || _X0[a].empty() ? T() : _X0[a][i];
+		}
+	}
+	_A.multiply(xk, rk, na);
+
+	std::vector<T> bnorm2(na, T()), rnorm2(na, T()), Mrkrk(na, T()), pkApk(na), alpha(na), Mrkp1rkp1(na);
+	for (int i = 0; i < n; i++) {
+		for (int a = 0; a < na; a++) {
+			rk[i*na + a] = _B[a][i] - rk[i*na + a];
+			pk[i*na + a] = rk[i*na + a]/_D[i];
+			bnorm2[a] += _B[a][i]*_B[a][i];
+			rnorm2[a] += rk[i*na + a]*rk[i*na + a];
+			Mrkrk[a] += pk[i*na + a]*rk[i*na + a];
+		}
+	}
+
+	for (int k = 0; na > 0; ++k) {
+		//----------Remove converged right hand sides----------
+		std::vector<int> keep;
+		for (int a = 0; a < na; a++) {
+			if (sqrt(rnorm2[a]) < _eps*sqrt(bnorm2[a]) || k == _itrmax) {
+				for (int i = 0; i < n; i++) {
+					X[active[a]][i] = xk[i*na + a];
+				}
+			} else {
+				keep.push_back(a);
+			}
+		}
+		if (keep.size() < na) {
+			int nk = keep.size();
+			for (int i = 0; i < n; i++) {
+				for (int b = 0; b < nk; b++) {
+					xk[i*nk + b] = xk[i*na + keep[b]];
+					rk[i*nk + b] = rk[i*na + keep[b]];
+					pk[i*nk + b] = pk[i*na + keep[b]];
+				}
+			}
+			for (int b = 0; b < nk; b++) {
+				active[b] = active[keep[b]];
+				bnorm2[b] = bnorm2[keep[b]];
+				Mrkrk[b] = Mrkrk[keep[b]];
+			}
+			na = nk;
+		}
+		if (k == _itrmax && na > 0) {
+			std::cout << "\nConvergence:faild" << std::endl;
+		}
+		if (k == _itrmax || na == 0) {
+			break;
+		}
+
+		//----------Get step length----------
+		_A.multiply(pk, Apk, na);
+		std::fill(pkApk.begin(), pkApk.end(), T());
+		T* ppkApk = pkApk.data();
+#pragma omp parallel for reduction(+:ppkApk[:na])
+		for (int i = 0; i < n; i++) {
+			for (int a = 0; a < na; a++) {
+				ppkApk[a] += pk[i*na + a]*Apk[i*na + a];
+			}
+		}
+		for (int a = 0; a < na; a++) {
+			alpha[a] = Mrkrk[a]/pkApk[a];
+		}
+
+		//----------Update x and r, and get scaled r----------
+		std::fill(Mrkp1rkp1.begin(), Mrkp1rkp1.end(), T());
+		std::fill(rnorm2.begin(), rnorm2.end(), T());
+		T* pMrkp1rkp1 = Mrkp1rkp1.data();
+		T* prnorm2 = rnorm2.data();
+#pragma omp parallel for reduction(+:pMrkp1rkp1[:na], prnorm2[:na])
+		for (int i = 0; i < n; i++) {
+			for (int a = 0; a < na; a++) {
+				xk[i*na + a] += alpha[a]*pk[i*na + a];
+				rk[i*na + a] -= alpha[a]*Apk[i*na + a];
+				Apk[i*na + a] = rk[i*na + a]/_D[i];			//Reuse Apk for scaled rk
+				pMrkp1rkp1[a] += Apk[i*na + a]*rk[i*na + a];
+				prnorm2[a] += rk[i*na + a]*rk[i*na + a];
+			}
+		}
+
+		//----------Update p----------
+		for (int a = 0; a < na; a++) {
+			alpha[a] = Mrkp1rkp1[a]/Mrkrk[a];				//Reuse alpha for beta
+			Mrkrk[a] = Mrkp1rkp1[a];
+		}
+#pragma omp parallel for
+		for (int i = 0; i < n; i++) {
+			for (int a = 0; a < na; a++) {
+				pk[i*na + a] = Apk[i*na + a] + alpha[a]*pk[i*na + a];
+			}
+		}
+	}
+
+	return X;
+}
+
+
 //********************Scaling preconditioning BiCGSTAB method********************
 template<class T>
-std::vector<T> ScalingBiCGSTAB(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps) {
+std::vector<T> ScalingBiCGSTAB(CSR<T>& _A, std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
+	return ScalingBiCGSTAB(_A, GetDiagonal(_A), _b, _itrmax, _eps, _x0);
+}
+
+
+//********************Scaling preconditioning BiCGSTAB method with given diagonal of _A********************
+template<class T>
+std::vector<T> ScalingBiCGSTAB(CSR<T>& _A, const std::vector<T>& _D, const std::vector<T>& _b, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Initialize----------
-	std::vector<T> D = GetDiagonal(_A);				//Scaling A matrix
-	std::vector<T> xk(_b.size(), T());
+	const std::vector<T>& D = _D;					//Scaling A matrix
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> rdash = rk;
 	std::vector<T> pk = Scaling(D, rk);
 	T rdashrk = std::inner_product(rdash.begin(), rdash.end(), rk.begin(), T());
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for (int k = 0; k < _itrmax; ++k) {
 		std::vector<T> Mpk = Scaling(D, pk);		//Preconditioning
@@ -533,15 +780,20 @@ std::vector<T> SOR(CSR<T>& _A, std::vector<T>& _b, T _w, int _itrmax, T _eps) {
 
 //********************SOR preconditioning CG method********************
 template<class T>
-std::vector<T> SORCG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps, T _soromega, int _soritermax, T _soreps) {
+std::vector<T> SORCG(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps, T _soromega, int _soritermax, T _soreps, const std::vector<T>& _x0 = std::vector<T>()) {
 	//----------Initialize----------
-	std::vector<T> xk(_b.size(), T());
+	std::vector<T> xk = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
 	std::vector<T> rk = subtract(_b, _A*xk);
 	std::vector<T> pk = SOR(_A, rk, _soromega, _soritermax, _soreps);		//Preconditioning SOR
 	std::vector<T> Mrk = pk;
 	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
 	T Mrkrk = std::inner_product(Mrk.begin(), Mrk.end(), rk.begin(), T());
 
+	//----------Check initial guess----------
+	if (sqrt(std::inner_product(rk.begin(), rk.end(), rk.begin(), T())) < _eps*bnorm) {
+		return xk;
+	}
+
 	//----------Iteration----------
 	for (int k = 0; k < _itrmax; ++k) {
 		std::vector<T> Apk = _A*pk;
@@ -0,0 +1,192 @@
+//*****************************************************************************
+//  Title		:   LinearAlgebra/Solvers/Cholesky.h
+//  Author	    :   Tanabe Yuta
+//  Date		:   2026/10/19
+//  Copyright	:   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+
+#include "../Models/Matrix.h"
+#include "../Models/Vector.h"
+
+
+namespace PANSFEM2{
+    //**********Cholesky decomposition A = L*L^T of symmetric positive definite matrix**********
+    //  Lower triangle of _A is overwritten by L and upper triangle is never referred.
+    //  Column k of L needs only rows of L above k, so rows below k are computed in parallel.
+    template<class T>
+    void Cholesky(Matrix<T>& _A){
+        int n = _A.ROW();
+        assert(n == _A.COL());
+
+        for(int k = 0; k < n; k++){
+            T* Ak = &_A(k, 0);
+            T Akk = Ak[k];
+            for(int p = 0; p < k; p++){
+                Akk -= Ak[p]*Ak[p];
+            }
+            assert(Akk > T());
+            Ak[k] = sqrt(Akk);
+
+#pragma omp parallel for if(n - k > 64)
+            for(int i = k + 1; i < n; i++){
+                T* Ai = &_A(i, 0);
+                T LiLk = T();
+#pragma omp simd reduction(+:LiLk)
+                for(int p = 0; p < k; p++){
+                    LiLk += Ai[p]*Ak[p];
+                }
+                Ai[k] = (Ai[k] - LiLk)/Ak[k];
+            }
+        }
+    }
+
+
+    //**********Solve L*L^T*x = b**********
+    template<class T>
+    void SolveCholesky(const Matrix<T>& _L, Vector<T>& _b){
+        int n = _L.ROW();
+        assert(n == _L.COL());
+        assert(n == _b.SIZE());
+
+        //----------Solve Ly=b----------
+        for(int i = 0; i < n; i++){
+            for(int j = 0; j < i; j++){
+                _b(i) -= _L(i, j)*_b(j);
+            }
+            _b(i) /= _L(i, i);
+        }
+
+        //----------Solve L^Tx=y----------
+        for(int i = n - 1; i >= 0; i--){
+            _b(i) /= _L(i, i);
+            for(int j = 0; j < i; j++){
+                _b(j) -= _L(i, j)*_b(i);
+            }
+        }
+    }
+
+
+    //**********Symmetric matrix with lower triangle in skyline (profile) storage**********
+    //  Row i holds columns [_first[i], i] contiguously, so fill-in of Cholesky stays inside the profile.
+    template<class T>
+    class SkylineMatrix{
+public:
+        SkylineMatrix();
+        ~SkylineMatrix();
+        SkylineMatrix(const std::vector<int>& _first);     //  _first[i]:First nonzero column of row i
+
+
+        std::vector<int> first;     //  First nonzero column of each row
+        std::vector<int> indptr;    //  Beginning of each row in data
+        std::vector<T> data;        //  Values of lower triangle
+
+
+        int SIZE() const;                               //  Number of rows
+        T& operator()(int _row, int _col);              //  Reference of (_row, _col) in lower profile
+        T operator()(int _row, int _col) const;         //  Value of (_row, _col) in lower profile
+    };
+
+
+    template<class T>
+    SkylineMatrix<T>::SkylineMatrix(){}
+
+
+    template<class T>
+    SkylineMatrix<T>::~SkylineMatrix(){}
+
+
+    template<class T>
+    SkylineMatrix<T>::SkylineMatrix(const std::vector<int>& _first){
+        this->first = _first;
+        this->indptr = std::vector<int>(_first.size() + 1, 0);
+        for(int i = 0; i < _first.size(); i++){
+            assert(0 <= _first[i] && _first[i] <= i);
+            this->indptr[i + 1] = this->indptr[i] + i - _first[i] + 1;
+        }
+        this->data = std::vector<T>(this->indptr[_first.size()], T());
+    }
+
+
+    template<class T>
+    int SkylineMatrix<T>::SIZE() const {
+        return this->first.size();
+    }
+
+
+    template<class T>
+    T& SkylineMatrix<T>::operator()(int _row, int _col){
+        assert(this->first[_row] <= _col && _col <= _row);
+        return this->data[this->indptr[_row] + _col - this->first[_row]];
+    }
+
+
+    template<class T>
+    T SkylineMatrix<T>::operator()(int _row, int _col) const {
+        assert(this->first[_row] <= _col && _col <= _row);
+        return this->data[this->indptr[_row] + _col - this->first[_row]];
+    }
+
+
+    //**********Cholesky decomposition A = L*L^T in skyline storage**********
+    //  Rows of L are made from top to bottom, and each entry needs a dot product of two contiguous rows.
+    template<class T>
+    void Cholesky(SkylineMatrix<T>& _A){
+        for(int i = 0; i < _A.SIZE(); i++){
+            int fi = _A.first[i];
+            T* Li = &_A.data[_A.indptr[i]];                    //  Li[j - fi] is L(i, j)
+            for(int j = fi; j < i; j++){
+                int fj = _A.first[j], pbegin = std::max(fi, fj);
+                const T* Lj = &_A.data[_A.indptr[j]];
+                T LiLj = T();
+#pragma omp simd reduction(+:LiLj)
+                for(int p = pbegin; p < j; p++){
+                    LiLj += Li[p - fi]*Lj[p - fj];
+                }
+                Li[j - fi] = (Li[j - fi] - LiLj)/Lj[j - fj];
+            }
+            T LiLi = T();
+#pragma omp simd reduction(+:LiLi)
+            for(int p = fi; p < i; p++){
+                LiLi += Li[p - fi]*Li[p - fi];
+            }
+            assert(Li[i - fi] > LiLi);
+            Li[i - fi] = sqrt(Li[i - fi] - LiLi);
+        }
+    }
+
+
+    //**********Solve L*L^T*x = b with L in skyline storage**********
+    template<class T>
+    void SolveCholesky(const SkylineMatrix<T>& _L, std::vector<T>& _b){
+        assert(_L.SIZE() == _b.size());
+
+        //----------Solve Ly=b----------
+        for(int i = 0; i < _L.SIZE(); i++){
+            int fi = _L.first[i];
+            const T* Li = &_L.data[_L.indptr[i]];
+            T Liy = T();
+            for(int j = fi; j < i; j++){
+                Liy += Li[j - fi]*_b[j];
+            }
+            _b[i] = (_b[i] - Liy)/Li[i - fi];
+        }
+
+        //----------Solve L^Tx=y----------
+        for(int i = _L.SIZE() - 1; i >= 0; i--){
+            int fi = _L.first[i];
+            const T* Li = &_L.data[_L.indptr[i]];
+            _b[i] /= Li[i - fi];
+            for(int j = fi; j < i; j++){
+                _b[j] -= Li[j - fi]*_b[i];
+            }
+        }
+    }
+}
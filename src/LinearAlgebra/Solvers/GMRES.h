@@ -0,0 +1,311 @@
+//*****************************************************************************
+//Title		:LinearAlgebra/Solvers/GMRES.h
+//Author	:Tanabe Yuta
+//Date		:2026/10/18
+//Copyright	:(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <numeric>
+#include <algorithm>
+#include <iostream>
+
+
+#include "../Models/CSR.h"
+#include "CG.h"
+
+
+//********************Orthogonalization of Arnoldi process********************
+enum class GMRESOrthogonalization {
+	MGS,			//Modified Gram-Schmidt
+	CGS2			//Classical Gram-Schmidt with reorthogonalization, inner products are blocked
+};
+
+
+//********************Workspace of GMRES(m) and FGMRES(m)********************
+//	Keep one workspace for repeated solves of same size, then no vector is allocated in iterations.
+template<class T>
+class GMRESWorkspace {
+public:
+	GMRESWorkspace();
+	GMRESWorkspace(int _n, int _m, bool _isflexible = false, GMRESOrthogonalization _orthogonalization = GMRESOrthogonalization::MGS);
+
+
+	int N;										//Size of system
+	int M;										//Restart
+	bool ISFLEXIBLE;							//Keep preconditioned basis for FGMRES or not
+	GMRESOrthogonalization ORTHOGONALIZATION;
+
+
+	bool isverbose;								//Report failure of convergence or not
+	std::vector<T> history;						//|r|/|b| at each iteration of last solve
+	int iterations;								//Iterations of last solve
+	bool isconverged;							//Last solve is converged or not
+
+
+	std::vector<std::vector<T> > V;				//Orthonormal basis of Krylov subspace
+	std::vector<std::vector<T> > Z;				//Preconditioned basis for FGMRES
+	std::vector<std::vector<T> > H;				//Hessenberg matrix
+	std::vector<T> cs, sn, g, h, y;				//Givens rotations, rotated residual, Gram-Schmidt coefficients and solution of least square
+	std::vector<T> r, w, z;						//Work vectors
+};
+
+
+template<class T>
+inline GMRESWorkspace<T>::GMRESWorkspace() : GMRESWorkspace(0, 30) {}
+
+
+template<class T>
+inline GMRESWorkspace<T>::GMRESWorkspace(int _n, int _m, bool _isflexible, GMRESOrthogonalization _orthogonalization) {
+	assert(_n >= 0 && _m > 0);
+	this->N = _n;
+	this->M = _m;
+	this->ISFLEXIBLE = _isflexible;
+	this->ORTHOGONALIZATION = _orthogonalization;
+
+	this->isverbose = true;
+	this->iterations = 0;
+	this->isconverged = false;
+
+	this->V = std::vector<std::vector<T> >(_m + 1, std::vector<T>(_n));
+	this->Z = std::vector<std::vector<T> >(_isflexible ? _m : 0, std::vector<T>(_n));
+	this->H = std::vector<std::vector<T> >(_m + 1, std::vector<T>(_m));
+	this->cs = std::vector<T>(_m);
+	this->sn = std::vector<T>(_m);
+	this->g = std::vector<T>(_m + 1);
+	this->h = std::vector<T>(_m + 1);
+	this->y = std::vector<T>(_m);
+	this->r = std::vector<T>(_n);
+	this->w = std::vector<T>(_n);
+	this->z = std::vector<T>(_n);
+}
+
+
+//********************Restarted GMRES(m) and FGMRES(m) with operators********************
+//	_A(v, Av) and _M(v, Mv) write products into second argument.
+//	_x is initial guess and returns solution. Preconditioning is right side, so the residual
+//	norm in history is the true one. FGMRES keeps each M*v and allows _M to change in iterations.
+template<class T, class FA, class FM>
+bool GMRES(FA _A, FM _M, const std::vector<T>& _b, std::vector<T>& _x, int _itrmax, T _eps, GMRESWorkspace<T>& _work) {
+	//----------Initialize----------
+	int n = _b.size();
+	assert(_work.N == n && _x.size() == n);
+	std::vector<std::vector<T> >& V = _work.V;
+	std::vector<std::vector<T> >& H = _work.H;
+	std::vector<T>& g = _work.g;
+	_work.history.clear();
+	_work.iterations = 0;
+	_work.isconverged = false;
+
+	T bnorm = sqrt(std::inner_product(_b.begin(), _b.end(), _b.begin(), T()));
+	if (bnorm == T()) {
+		std::fill(_x.begin(), _x.end(), T());
+		_work.history.push_back(T());
+		_work.isconverged = true;
+		return true;
+	}
+
+	//----------Restart loop----------
+	for (int k = 0; k < _itrmax; ) {
+		//----------Get residual r = b - A*x----------
+		if (std::all_of(_x.begin(), _x.end(), [](T _xi) { return _xi == T(); })) {
+			_work.r = _b;
+		} else {
+			_A(_x, _work.r);
+			for (int i = 0; i < n; i++) {
+				_work.r[i] = _b[i] - _work.r[i];
+			}
+		}
+		T beta = sqrt(std::inner_product(_work.r.begin(), _work.r.end(), _work.r.begin(), T()));
+		if (k == 0) {
+			_work.history.push_back(beta/bnorm);
+		}
+		if (beta < _eps*bnorm) {
+			_work.isconverged = true;
+			return true;
+		}
+		for (int i = 0; i < n; i++) {
+			V[0][i] = _work.r[i]/beta;
+		}
+		std::fill(g.begin(), g.end(), T());
+		g[0] = beta;
+
+		//----------Arnoldi process----------
+		int j = 0;
+		while (j < _work.M && k < _itrmax) {
+			std::vector<T>& z = _work.ISFLEXIBLE ? _work.Z[j] : _work.z;
+			std::vector<T>& w = _work.w;
+			_M(V[j], z);
+			_A(z, w);
+
+			if (_work.ORTHOGONALIZATION == GMRESOrthogonalization::MGS) {
+				for (int i = 0; i <= j; i++) {
+					H[i][j] = std::inner_product(w.begin(), w.end(), V[i].begin(), T());
+					xexpay(w, -H[i][j], V[i]);
+				}
+			} else {
+				//  Inner products with all basis are taken in one sweep of w, and repeated once
+				for (int i = 0; i <= j; i++) {
+					H[i][j] = T();
+				}
+				for (int pass = 0; pass < 2; pass++) {
+					std::fill(_work.h.begin(), _work.h.begin() + j + 1, T());
+					for (int l = 0; l < n; l++) {
+						for (int i = 0; i <= j; i++) {
+							_work.h[i] += V[i][l]*w[l];
+						}
+					}
+					for (int l = 0; l < n; l++) {
+						T wl = w[l];
+						for (int i = 0; i <= j; i++) {
+							wl -= _work.h[i]*V[i][l];
+						}
+						w[l] = wl;
+					}
+					for (int i = 0; i <= j; i++) {
+						H[i][j] += _work.h[i];
+					}
+				}
+			}
+			H[j + 1][j] = sqrt(std::inner_product(w.begin(), w.end(), w.begin(), T()));
+			if (H[j + 1][j] != T()) {
+				for (int l = 0; l < n; l++) {
+					V[j + 1][l] = w[l]/H[j + 1][j];
+				}
+			}
+
+			//  Apply previous rotations and make new rotation
+			for (int i = 0; i < j; i++) {
+				T hij = H[i][j];
+				H[i][j] = _work.cs[i]*hij + _work.sn[i]*H[i + 1][j];
+				H[i + 1][j] = -_work.sn[i]*hij + _work.cs[i]*H[i + 1][j];
+			}
+			T rho = sqrt(H[j][j]*H[j][j] + H[j + 1][j]*H[j + 1][j]);
+			_work.cs[j] = rho != T() ? H[j][j]/rho : 1.0;
+			_work.sn[j] = rho != T() ? H[j + 1][j]/rho : T();
+			H[j][j] = rho;
+			H[j + 1][j] = T();
+			g[j + 1] = -_work.sn[j]*g[j];
+			g[j] = _work.cs[j]*g[j];
+
+			j++;
+			k++;
+			_work.iterations = k;
+			_work.history.push_back(fabs(g[j])/bnorm);
+			if (fabs(g[j]) < _eps*bnorm || H[j - 1][j - 1] == T()) {
+				break;
+			}
+		}
+
+		//----------Update solution with y = H^-1*g----------
+		for (int i = j - 1; i >= 0; i--) {
+			_work.y[i] = g[i];
+			for (int l = i + 1; l < j; l++) {
+				_work.y[i] -= H[i][l]*_work.y[l];
+			}
+			_work.y[i] = H[i][i] != T() ? _work.y[i]/H[i][i] : T();
+		}
+		if (_work.ISFLEXIBLE) {
+			for (int i = 0; i < j; i++) {
+				xexpay(_x, _work.y[i], _work.Z[i]);
+			}
+		} else {
+			std::fill(_work.w.begin(), _work.w.end(), T());
+			for (int i = 0; i < j; i++) {
+				xexpay(_work.w, _work.y[i], V[i]);
+			}
+			_M(_work.w, _work.z);
+			xexpay(_x, (T)1.0, _work.z);
+		}
+
+		if (fabs(g[j]) < _eps*bnorm) {
+			_work.isconverged = true;
+			return true;
+		}
+	}
+
+	if (_work.isverbose) {
+		std::cout << "\nConvergence:faild" << std::endl;
+	}
+	return false;
+}
+
+
+//********************GMRES(m) method with workspace********************
+template<class T>
+std::vector<T> GMRES(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps, GMRESWorkspace<T>& _work, const std::vector<T>& _x0 = std::vector<T>()) {
+	std::vector<T> x = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
+	GMRES([&](const std::vector<T>& _v, std::vector<T>& _Av) { _A.multiply(_v, _Av); }, [](const std::vector<T>& _v, std::vector<T>& _Mv) { _Mv = _v; }, _b, x, _itrmax, _eps, _work);
+	return x;
+}
+
+
+//********************GMRES(m) method********************
+template<class T>
+std::vector<T> GMRES(CSR<T>& _A, const std::vector<T>& _b, int _m, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
+	GMRESWorkspace<T> work = GMRESWorkspace<T>(_b.size(), _m);
+	return GMRES(_A, _b, _itrmax, _eps, work, _x0);
+}
+
+
+//********************Scaling preconditioning GMRES(m) method with workspace********************
+template<class T>
+std::vector<T> ScalingGMRES(CSR<T>& _A, const std::vector<T>& _b, int _itrmax, T _eps, GMRESWorkspace<T>& _work, const std::vector<T>& _x0 = std::vector<T>()) {
+	std::vector<T> D = GetDiagonal(_A);
+	std::vector<T> x = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
+	GMRES([&](const std::vector<T>& _v, std::vector<T>& _Av) { _A.multiply(_v, _Av); }, [&](const std::vector<T>& _v, std::vector<T>& _Mv) {
+		for (int i = 0; i < _v.size(); i++) {
+			_Mv[i] = _v[i]/D[i];
+		}
+	}, _b, x, _itrmax, _eps, _work);
+	return x;
+}
+
+
+//********************Scaling preconditioning GMRES(m) method********************
+template<class T>
+std::vector<T> ScalingGMRES(CSR<T>& _A, const std::vector<T>& _b, int _m, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
+	GMRESWorkspace<T> work = GMRESWorkspace<T>(_b.size(), _m);
+	return ScalingGMRES(_A, _b, _itrmax, _eps, work, _x0);
+}
+
+
+//********************ILU(0) preconditioning GMRES(m) method with workspace********************
+template<class T>
+std::vector<T> ILU0GMRES(CSR<T>& _A, CSR<T>& _M, const std::vector<T>& _b, int _itrmax, T _eps, GMRESWorkspace<T>& _work, const std::vector<T>& _x0 = std::vector<T>()) {
+	std::vector<T> x = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
+	GMRES([&](const std::vector<T>& _v, std::vector<T>& _Av) { _A.multiply(_v, _Av); }, [&](const std::vector<T>& _v, std::vector<T>& _Mv) { PreILU0(_M, _v, _Mv); }, _b, x, _itrmax, _eps, _work);
+	return x;
+}
+
+
+//********************ILU(0) preconditioning GMRES(m) method********************
+template<class T>
+std::vector<T> ILU0GMRES(CSR<T>& _A, CSR<T>& _M, const std::vector<T>& _b, int _m, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
+	GMRESWorkspace<T> work = GMRESWorkspace<T>(_b.size(), _m);
+	return ILU0GMRES(_A, _M, _b, _itrmax, _eps, work, _x0);
+}
+
+
+//********************Flexible GMRES(m) method with variable preconditioner and workspace********************
+//	_M(v, Mv) writes approximation of A^-1*v such as inner iterations into Mv, which may change in every call.
+//	_M is taken by reference, so a preconditioner object such as BlockTriangularPreconditioner is passed directly.
+template<class T, class FM>
+std::vector<T> FGMRES(CSR<T>& _A, FM&& _M, const std::vector<T>& _b, int _itrmax, T _eps, GMRESWorkspace<T>& _work, const std::vector<T>& _x0 = std::vector<T>()) {
+	assert(_work.ISFLEXIBLE);
+	std::vector<T> x = _x0.empty() ? std::vector<T>(_b.size(), T()) : _x0;
+	GMRES([&](const std::vector<T>& _v, std::vector<T>& _Av) { _A.multiply(_v, _Av); }, [&](const std::vector<T>& _v, std::vector<T>& _Mv) { _M(_v, _Mv); }, _b, x, _itrmax, _eps, _work);
+	return x;
+}
+
+
+//********************Flexible GMRES(m) method with variable preconditioner********************
+template<class T, class FM>
+std::vector<T> FGMRES(CSR<T>& _A, FM&& _M, const std::vector<T>& _b, int _m, int _itrmax, T _eps, const std::vector<T>& _x0 = std::vector<T>()) {
+	GMRESWorkspace<T> work = GMRESWorkspace<T>(_b.size(), _m, true);
+	return FGMRES(_A, _M, _b, _itrmax, _eps, work, _x0);
+}
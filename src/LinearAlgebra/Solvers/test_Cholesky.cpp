@@ -0,0 +1,38 @@
+#include <iostream>
+
+#include "../Models/Matrix.h"
+#include "Cholesky.h"
+
+using namespace PANSFEM2;
+
+int main(){
+    Matrix<double> A = Matrix<double>(4, 4);
+    A(0, 0) = 4.0;  A(0, 1) = 2.0;  A(0, 2) = 0.0;  A(0, 3) = 1.0;
+    A(1, 0) = 2.0;  A(1, 1) = 5.0;  A(1, 2) = 1.0;  A(1, 3) = 0.0;
+    A(2, 0) = 0.0;  A(2, 1) = 1.0;  A(2, 2) = 3.0;  A(2, 3) = 1.0;
+    A(3, 0) = 1.0;  A(3, 1) = 0.0;  A(3, 2) = 1.0;  A(3, 3) = 2.0;
+    Cholesky(A);
+    Vector<double> b = Vector<double>(4);
+    b(0) = 7.0;
+    b(1) = 8.0;
+    b(2) = 5.0;
+    b(3) = 4.0;
+    SolveCholesky(A, b);
+    std::cout << b << std::endl;        //  1, 1, 1, 1
+
+    //----------Same matrix in skyline storage----------
+    SkylineMatrix<double> S = SkylineMatrix<double>({ 0, 0, 1, 0 });
+    S(0, 0) = 4.0;
+    S(1, 0) = 2.0;  S(1, 1) = 5.0;
+    S(2, 1) = 1.0;  S(2, 2) = 3.0;
+    S(3, 0) = 1.0;  S(3, 1) = 0.0;  S(3, 2) = 1.0;  S(3, 3) = 2.0;
+    Cholesky(S);
+    std::vector<double> c = { 7.0, 8.0, 5.0, 4.0 };
+    SolveCholesky(S, c);
+    for(auto ci : c){
+        std::cout << ci << "\t";       //  1, 1, 1, 1
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+
+#include "../Models/CSR.h"
+#include "GMRES.h"
+
+int main(){
+    //----------Upwind convection-diffusion on n x n grid----------
+    int n = 30, N = n*n;
+    LILCSR<double> L = LILCSR<double>(N, N);
+    for(int i = 0; i < n; i++){
+        for(int j = 0; j < n; j++){
+            int k = i*n + j;
+            L.set(k, k, 4.0 + 20.0);
+            if(i > 0)       L.set(k, k - n, -1.0 - 20.0);
+            if(i < n - 1)   L.set(k, k + n, -1.0);
+            if(j > 0)       L.set(k, k - 1, -1.0);
+            if(j < n - 1)   L.set(k, k + 1, -1.0);
+        }
+    }
+    CSR<double> A = CSR<double>(L);
+    std::vector<double> x = std::vector<double>(N, 1.0);
+    std::vector<double> b = A*x;
+
+    auto error = [&](const std::vector<double>& _x) {
+        double e = 0.0;
+        for(auto xi : _x) {
+            e = std::max(e, fabs(xi - 1.0));
+        }
+        return e;
+    };
+
+    GMRESWorkspace<double> work = GMRESWorkspace<double>(N, 30);
+    x = GMRES(A, b, 1000, 1.0e-10, work);
+    std::cout << "GMRES\t" << work.iterations << "\t" << error(x) << std::endl;
+
+    GMRESWorkspace<double> work2 = GMRESWorkspace<double>(N, 30, false, GMRESOrthogonalization::CGS2);
+    x = GMRES(A, b, 1000, 1.0e-10, work2);
+    std::cout << "GMRES CGS2\t" << work2.iterations << "\t" << error(x) << std::endl;
+
+    CSR<double> M = ILU0(A);
+    x = ILU0GMRES(A, M, b, 1000, 1.0e-10, work);
+    std::cout << "ILU0GMRES\t" << work.iterations << "\t" << error(x) << std::endl;
+    for(auto historyi : work.history) {
+        std::cout << historyi << "\t";
+    }
+    std::cout << std::endl;
+
+    //----------Inner GMRES as variable preconditioner----------
+    GMRESWorkspace<double> work3 = GMRESWorkspace<double>(N, 10, true);
+    GMRESWorkspace<double> inner = GMRESWorkspace<double>(N, 5);
+    x = FGMRES(A, [&](const std::vector<double>& _v, std::vector<double>& _z) {
+        std::fill(_z.begin(), _z.end(), 0.0);
+        GMRES([&](const std::vector<double>& _p, std::vector<double>& _Ap) { A.multiply(_p, _Ap); }, [&](const std::vector<double>& _p, std::vector<double>& _Mp) { PreILU0(M, _p, _Mp); }, _v, _z, 5, 1.0e-1, inner);
+    }, b, 1000, 1.0e-10, work3);
+    std::cout << "FGMRES\t" << work3.iterations << "\t" << error(x) << std::endl;
+
+    x = BiCGSTAB2(A, b, 1000, 1.0e-10);
+    std::cout << "BiCGSTAB2\t" << error(x) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <iostream>
+#include <cmath>
+#include <numeric>
+
+#include "../Models/CSR.h"
+#include "CG.h"
+
+int main(){
+    //----------Nonsymmetric convection-diffusion like matrix----------
+    int n = 100;
+    LILCSR<double> Alil = LILCSR<double>(n, n);
+    for(int i = 0; i < n; i++){
+        Alil.set(i, i, 4.0);
+        if(i > 0)       Alil.set(i, i - 1, -1.5);
+        if(i < n - 1)   Alil.set(i, i + 1, -0.5);
+        if(i > 9)       Alil.set(i, i - 10, -1.0);
+        if(i < n - 10)  Alil.set(i, i + 10, -0.25);
+    }
+    CSR<double> A = CSR<double>(Alil);
+    CSR<double> M = ILU0(A);
+
+    std::vector<double> x = std::vector<double>(n);
+    for(int i = 0; i < n; i++){
+        x[i] = sin(0.1*i) + 1.0;
+    }
+
+    //----------A^T*x with forward matrix----------
+    std::vector<double> b, bref = Transpose(A)*x;
+    A.multiplyTranspose(x, b);
+    double errormultiply = 0.0;
+    for(int i = 0; i < n; i++){
+        errormultiply = std::max(errormultiply, fabs(b[i] - bref[i]));
+    }
+
+    //----------(LU)^-T with forward factor, check c.(LU)^-T*b = ((LU)^-1*c).b----------
+    std::vector<double> c = std::vector<double>(n), MTb, Mc;
+    for(int i = 0; i < n; i++){
+        c[i] = cos(0.3*i);
+    }
+    PreILU0Transpose(M, b, MTb);
+    PreILU0(M, c, Mc);
+    double errorpreconditioner = fabs(std::inner_product(c.begin(), c.end(), MTb.begin(), 0.0) - std::inner_product(Mc.begin(), Mc.end(), b.begin(), 0.0));
+
+    //----------Adjoint solve A^T*x = b with forward ILU(0)----------
+    std::vector<double> xsolved = ILU0BiCGSTABTranspose(A, M, b, 1000, 1.0e-12);
+    double errorsolve = 0.0;
+    for(int i = 0; i < n; i++){
+        errorsolve = std::max(errorsolve, fabs(xsolved[i] - x[i]));
+    }
+
+    std::cout << "multiplyTranspose error = " << errormultiply << std::endl;
+    std::cout << "PreILU0Transpose error = " << errorpreconditioner << std::endl;
+    std::cout << "ILU0BiCGSTABTranspose error = " << errorsolve << std::endl;
+
+    return 0;
+}
@@ -10,30 +10,41 @@
 #include <vector>
 
 
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "FilterMatrix.h"
+
+
 namespace PANSFEM2{
     //**********Density filter class**********
+    //  rho = H*s with row normalized filter matrix H, so that dfds = H^T*dfdrho
     template<class T>
     class DensityFilter{
 public:
-        DensityFilter(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w);
+        DensityFilter(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w);
+        DensityFilter(const CSR<T>& _H);
         ~DensityFilter();
             
 
-        std::vector<T> GetFilteredVariables(std::vector<T> _s);                                 //  Return filtered variables
-        std::vector<T> GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfdrho);      //  Return filtered sensitivities
+        std::vector<T> GetFilteredVariables(const std::vector<T>& _s);                                      //  Return filtered variables
+        std::vector<T> GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfdrho);    //  Return filtered sensitivities
 
     
 private:
         const int n;                                //  Number of design variables 
-        std::vector<std::vector<int> > neighbors;   //  Index list of neighbor element
-        std::vector<std::vector<T> > w;             //  Weight list of neighbor element    
+        CSR<T> H;                                   //  Filter matrix
+        CSR<T> HT;                                  //  Transpose of filter matrix
     };
 
 
     template<class T>
-    DensityFilter<T>::DensityFilter(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w) : n(_n){
-        this->neighbors = _neighbors;
-        this->w = _w;
+    DensityFilter<T>::DensityFilter(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w) : DensityFilter(FilterMatrix(_n, _neighbors, _w)){}
+
+
+    template<class T>
+    DensityFilter<T>::DensityFilter(const CSR<T>& _H) : n(_H.ROWS){
+        assert(_H.ROWS == _H.COLS);
+        this->H = _H;
+        this->HT = Transpose(_H);
     }
     
 
@@ -42,31 +53,13 @@ private:
 
 
     template<class T>
-    std::vector<T> DensityFilter<T>::GetFilteredVariables(std::vector<T> _s){
-        std::vector<T> rho = std::vector<T>(this->n);
-        for(int i = 0; i < this->n; i++){
-            T wsum = T();
-            for(int j = 0; j < this->neighbors[i].size(); j++){
-                rho[i] += this->w[i][j]*_s[this->neighbors[i][j]];
-                wsum += this->w[i][j];
-            }
-            rho[i] /= wsum;
-        }
-        return rho;
+    std::vector<T> DensityFilter<T>::GetFilteredVariables(const std::vector<T>& _s){
+        return this->H*_s;
     }
 
 
     template<class T>
-    std::vector<T> DensityFilter<T>::GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfdrho){
-        std::vector<T> dfds = std::vector<T>(this->n);
-        for(int i = 0; i < this->n; i++){
-            T wsum = T();
-            for(int j = 0; j < this->neighbors[i].size(); j++){
-                dfds[i] += _dfdrho[this->neighbors[i][j]]*this->w[i][j];
-                wsum += this->w[i][j];
-            }
-            dfds[i] /= wsum;       
-        }
-        return dfds;
+    std::vector<T> DensityFilter<T>::GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfdrho){
+        return this->HT*_dfdrho;
     }
-}
\ No newline at end of file
+}
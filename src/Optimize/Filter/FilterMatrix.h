@@ -0,0 +1,59 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Filter/FilterMatrix.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/19
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cassert>
+
+
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Models/LILCSR.h"
+#include "NeighborSearch.h"
+
+
+namespace PANSFEM2{
+    //**********Row normalized filter matrix H_ij = w_ij/sum_k w_ik from neighbor lists**********
+    template<class T>
+    CSR<T> FilterMatrix(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w){
+        assert(_neighbors.size() == _n && _w.size() == _n);
+        LILCSR<T> H = LILCSR<T>(_n, _n);
+#pragma omp parallel for
+        for(int i = 0; i < _n; i++){
+            assert(_neighbors[i].size() == _w[i].size());
+            T wsum = T();
+            for(int j = 0; j < _w[i].size(); j++){
+                wsum += _w[i][j];
+            }
+            assert(wsum > T());
+            for(int j = 0; j < _neighbors[i].size(); j++){
+                H.set(i, _neighbors[i][j], _w[i][j]/wsum);
+            }
+        }
+        return CSR<T>(H);
+    }
+
+
+    //**********Row normalized filter matrix with linear weight w_ij = (R - |x_i - x_j|)/R**********
+    template<class T>
+    CSR<T> FilterMatrix(const NeighborSearch<T>& _neighborsearch, T _R){
+        int n = _neighborsearch.SIZE();
+        LILCSR<T> H = LILCSR<T>(n, n);
+#pragma omp parallel for
+        for(int i = 0; i < n; i++){
+            T wsum = T();
+            for(int k = _neighborsearch.indptr[i]; k < _neighborsearch.indptr[i + 1]; k++){
+                wsum += (_R - _neighborsearch.distances[k])/_R;
+            }
+            assert(wsum > T());
+            for(int k = _neighborsearch.indptr[i]; k < _neighborsearch.indptr[i + 1]; k++){
+                H.set(i, _neighborsearch.indices[k], (_R - _neighborsearch.distances[k])/_R/wsum);
+            }
+        }
+        return CSR<T>(H);
+    }
+}
@@ -8,28 +8,41 @@
 
 #pragma once
 #include <vector>
+#include <cmath>
+
+
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "FilterMatrix.h"
 
 
 namespace PANSFEM2{
     //**********Heaviside filter class**********
+    //  rho = Heaviside(stilde) with stilde = H*s, so that dfds = H^T*(dfdrho*drhodstilde)
+    //  stilde is kept until the filter is called with other s.
     template<class T>
     class HeavisideFilter{
 public:
         HeavisideFilter();
         ~HeavisideFilter();
-        HeavisideFilter(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w);
+        HeavisideFilter(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w);
+        HeavisideFilter(const CSR<T>& _H);
     
 
         void UpdateBeta(T _beta);
-        std::vector<T> GetFilteredVariables(std::vector<T> _s);            //  Return filtered variables
-        std::vector<T> GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfdrho);    //  Return filtered sensitivities
+        std::vector<T> GetFilteredVariables(const std::vector<T>& _s);                                      //  Return filtered variables
+        std::vector<T> GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfdrho);    //  Return filtered sensitivities
 
     
 private:
         const int n;                                //  Number of design variables 
         T beta;                                     //  Parameter of Heaviside filter
-        std::vector<std::vector<int> > neighbors;   //  Index list of neighbor element
-        std::vector<std::vector<T> > w;             //  Weight list of neighbor element    
+        CSR<T> H;                                   //  Filter matrix
+        CSR<T> HT;                                  //  Transpose of filter matrix
+        std::vector<T> s;                           //  Design variables of stilde
+        std::vector<T> stilde;                      //  Smoothed design variables
+
+
+        void UpdateSmoothedVariables(const std::vector<T>& _s);
     };
 
 
@@ -44,10 +57,15 @@ private:
 
 
     template<class T>
-    HeavisideFilter<T>::HeavisideFilter(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w) : n(_n){
+    HeavisideFilter<T>::HeavisideFilter(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w) : HeavisideFilter(FilterMatrix(_n, _neighbors, _w)){}
+
+
+    template<class T>
+    HeavisideFilter<T>::HeavisideFilter(const CSR<T>& _H) : n(_H.ROWS){
+        assert(_H.ROWS == _H.COLS);
         this->beta = 1.0;
-        this->neighbors = _neighbors;
-        this->w = _w;
+        this->H = _H;
+        this->HT = Transpose(_H);
     }
 
 
@@ -58,43 +76,36 @@ private:
 
 
     template<class T>
-    std::vector<T> HeavisideFilter<T>::GetFilteredVariables(std::vector<T> _s){
+    std::vector<T> HeavisideFilter<T>::GetFilteredVariables(const std::vector<T>& _s){
+        this->UpdateSmoothedVariables(_s);
         std::vector<T> rho = std::vector<T>(this->n);
+        T beta = this->beta, tanhbeta = tanh(0.5*this->beta);
+#pragma omp parallel for
         for(int i = 0; i < this->n; i++){
-            T wssum = T();
-            T wsum = T();
-            for(int j = 0; j < this->neighbors[i].size(); j++){
-                wssum += this->w[i][j]*_s[this->neighbors[i][j]];
-                wsum += this->w[i][j];
-            }
-            rho[i] = 0.5*(tanh(0.5*this->beta) + tanh(this->beta*(wssum/wsum - 0.5)))/tanh(0.5*this->beta);
+            rho[i] = 0.5*(tanhbeta + tanh(beta*(this->stilde[i] - 0.5)))/tanhbeta;
         }
         return rho;
     }
 
 
     template<class T>
-    std::vector<T> HeavisideFilter<T>::GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfdrho){
-        std::vector<T> drhodstilde = std::vector<T>(this->n);
+    std::vector<T> HeavisideFilter<T>::GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfdrho){
+        this->UpdateSmoothedVariables(_s);
+        std::vector<T> dfdstilde = std::vector<T>(this->n);
+        T beta = this->beta, tanhbeta = tanh(0.5*this->beta);
+#pragma omp parallel for
         for(int i = 0; i < this->n; i++){
-            T wssum = T();
-            T wsum = T();
-            for(int j = 0; j < this->neighbors[i].size(); j++){
-                wssum += this->w[i][j]*_s[this->neighbors[i][j]];
-                wsum += this->w[i][j];
-            }
-            drhodstilde[i] = 0.5*this->beta*(1.0 - pow(tanh(this->beta*(wssum/wsum - 0.5)), 2.0))/tanh(0.5*this->beta);
+            dfdstilde[i] = _dfdrho[i]*0.5*beta*(1.0 - pow(tanh(beta*(this->stilde[i] - 0.5)), 2.0))/tanhbeta;
         }
-        
-        std::vector<T> dfds = std::vector<T>(this->n);
-        for(int i = 0; i < this->n; i++){
-            T wsum = T();
-            for(int j = 0; j < this->neighbors[i].size(); j++){
-                dfds[i] += _dfdrho[this->neighbors[i][j]]*drhodstilde[this->neighbors[i][j]]*this->w[i][j];
-                wsum += this->w[i][j];
-            }
-            dfds[i] /= wsum;       
+        return this->HT*dfdstilde;
+    }
+
+
+    template<class T>
+    void HeavisideFilter<T>::UpdateSmoothedVariables(const std::vector<T>& _s){
+        if(this->stilde.size() != this->n || _s != this->s){
+            this->s = _s;
+            this->H.multiply(_s, this->stilde);
         }
-        return dfds;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,223 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Filter/NeighborSearch.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/19
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+
+#include "../../LinearAlgebra/Models/Vector.h"
+
+
+namespace PANSFEM2{
+    //**********Radius neighbor search with uniform bucket grid**********
+    //  Neighbors of point i are indices[indptr[i]] ... indices[indptr[i + 1] - 1] in ascending order,
+    //  and distances[k] is the distance between point i and indices[k].
+    //  Buckets are not smaller than _R, so only adjacent buckets are searched.
+    template<class T>
+    class NeighborSearch{
+public:
+        NeighborSearch(const std::vector<Vector<T> >& _x, T _R);
+        ~NeighborSearch();
+
+
+        std::vector<int> indptr;                    //  Start of neighbor list of each point
+        std::vector<int> indices;                   //  Index of neighbor points
+        std::vector<T> distances;                   //  Distance to neighbor points
+
+
+        int SIZE() const;                           //  Number of points
+        int NNZ() const;                            //  Number of neighbor pairs
+
+
+private:
+        const int n;                                //  Number of points
+        const int dim;                              //  Dimension of points
+        T R;                                        //  Search radius
+        T h;                                        //  Size of bucket
+        std::vector<T> xmin;                        //  Lower corner of grid
+        std::vector<int> nbucket;                   //  Number of buckets along each axis
+        std::vector<int> bucketptr;                 //  Start of point list of each bucket
+        std::vector<int> bucketitems;               //  Points sorted by bucket
+        std::vector<T> bucketx;                     //  Coordinates of points sorted by bucket
+
+
+        int BucketIndex(const Vector<T>& _x, int _d) const;
+        template<class F>
+        void ForEachNeighbor(const std::vector<Vector<T> >& _x, int _i, F _f) const;
+    };
+
+
+    template<class T>
+    NeighborSearch<T>::NeighborSearch(const std::vector<Vector<T> >& _x, T _R) : n(_x.size()), dim(_x.empty() ? 0 : _x[0].SIZE()){
+        assert(_R > T());
+        assert(this->dim <= 3);
+        this->R = _R;
+
+        //----------Get bounding box----------
+        this->xmin = std::vector<T>(this->dim, T());
+        std::vector<T> xmax = std::vector<T>(this->dim, T());
+        for(int d = 0; d < this->dim; d++){
+            this->xmin[d] = this->n > 0 ? _x[0](d) : T();
+            xmax[d] = this->xmin[d];
+        }
+        for(const auto& xi : _x){
+            for(int d = 0; d < this->dim; d++){
+                this->xmin[d] = std::min(this->xmin[d], xi(d));
+                xmax[d] = std::max(xmax[d], xi(d));
+            }
+        }
+
+        //----------Enlarge buckets until their number is O(n)----------
+        this->h = _R;
+        this->nbucket = std::vector<int>(this->dim, 1);
+        for(;;){
+            double nbuckettotal = 1.0;
+            for(int d = 0; d < this->dim; d++){
+                nbuckettotal *= floor((xmax[d] - this->xmin[d])/this->h) + 1.0;
+            }
+            if(nbuckettotal <= 4.0*this->n + 1.0){
+                break;
+            }
+            this->h *= 2.0;
+        }
+        int nbuckettotal = 1;
+        for(int d = 0; d < this->dim; d++){
+            this->nbucket[d] = (int)floor((xmax[d] - this->xmin[d])/this->h) + 1;
+            nbuckettotal *= this->nbucket[d];
+        }
+
+        //----------Sort points into buckets with counting sort----------
+        std::vector<int> bucketofpoint = std::vector<int>(this->n);
+        this->bucketptr = std::vector<int>(nbuckettotal + 1, 0);
+        for(int i = 0; i < this->n; i++){
+            int bucket = 0;
+            for(int d = this->dim - 1; d >= 0; d--){
+                bucket = bucket*this->nbucket[d] + this->BucketIndex(_x[i], d);
+            }
+            bucketofpoint[i] = bucket;
+            this->bucketptr[bucket + 1]++;
+        }
+        for(int b = 0; b < nbuckettotal; b++){
+            this->bucketptr[b + 1] += this->bucketptr[b];
+        }
+        this->bucketitems = std::vector<int>(this->n);
+        std::vector<int> bucketfill = std::vector<int>(this->bucketptr.begin(), this->bucketptr.end() - 1);
+        for(int i = 0; i < this->n; i++){
+            this->bucketitems[bucketfill[bucketofpoint[i]]++] = i;
+        }
+        this->bucketx = std::vector<T>(this->n*this->dim);
+        for(int p = 0; p < this->n; p++){
+            for(int d = 0; d < this->dim; d++){
+                this->bucketx[p*this->dim + d] = _x[this->bucketitems[p]](d);
+            }
+        }
+
+        //----------Count neighbors----------
+        this->indptr = std::vector<int>(this->n + 1, 0);
+#pragma omp parallel for
+        for(int i = 0; i < this->n; i++){
+            int count = 0;
+            this->ForEachNeighbor(_x, i, [&](int, T){
+                count++;
+            });
+            this->indptr[i + 1] = count;
+        }
+        for(int i = 0; i < this->n; i++){
+            this->indptr[i + 1] += this->indptr[i];
+        }
+
+        //----------Store neighbors----------
+        this->indices = std::vector<int>(this->indptr[this->n]);
+        this->distances = std::vector<T>(this->indptr[this->n]);
+#pragma omp parallel
+        {
+            std::vector<std::pair<int, T> > neighbor;
+#pragma omp for
+            for(int i = 0; i < this->n; i++){
+                neighbor.clear();
+                this->ForEachNeighbor(_x, i, [&](int _j, T _distance){
+                    neighbor.push_back({ _j, _distance });
+                });
+                std::sort(neighbor.begin(), neighbor.end(), [](const std::pair<int, T>& _a, const std::pair<int, T>& _b){
+                    return _a.first < _b.first;
+                });
+                for(int k = 0; k < neighbor.size(); k++){
+                    this->indices[this->indptr[i] + k] = neighbor[k].first;
+                    this->distances[this->indptr[i] + k] = neighbor[k].second;
+                }
+            }
+        }
+    }
+
+
+    template<class T>
+    NeighborSearch<T>::~NeighborSearch(){}
+
+
+    template<class T>
+    int NeighborSearch<T>::SIZE() const{
+        return this->n;
+    }
+
+
+    template<class T>
+    int NeighborSearch<T>::NNZ() const{
+        return this->indptr[this->n];
+    }
+
+
+    template<class T>
+    int NeighborSearch<T>::BucketIndex(const Vector<T>& _x, int _d) const{
+        int index = (int)floor((_x(_d) - this->xmin[_d])/this->h);
+        return std::min(std::max(index, 0), this->nbucket[_d] - 1);
+    }
+
+
+    template<class T>
+    template<class F>
+    void NeighborSearch<T>::ForEachNeighbor(const std::vector<Vector<T> >& _x, int _i, F _f) const{
+        //----------Range of adjacent buckets----------
+        int begin[3] = { 0, 0, 0 }, end[3] = { 1, 1, 1 };
+        T xi[3] = { T(), T(), T() };
+        for(int d = 0; d < this->dim; d++){
+            xi[d] = _x[_i](d);
+            int index = this->BucketIndex(_x[_i], d);
+            begin[d] = std::max(index - 1, 0);
+            end[d] = std::min(index + 2, this->nbucket[d]);
+        }
+
+        //----------Check distance to points in adjacent buckets----------
+        for(int b2 = begin[2]; b2 < end[2]; b2++){
+            for(int b1 = begin[1]; b1 < end[1]; b1++){
+                for(int b0 = begin[0]; b0 < end[0]; b0++){
+                    int bucket = b0;
+                    if(this->dim > 1){
+                        bucket += this->nbucket[0]*b1;
+                    }
+                    if(this->dim > 2){
+                        bucket += this->nbucket[0]*this->nbucket[1]*b2;
+                    }
+                    for(int p = this->bucketptr[bucket]; p < this->bucketptr[bucket + 1]; p++){
+                        const T* xj = &this->bucketx[p*this->dim];
+                        T distance2 = T();
+                        for(int d = 0; d < this->dim; d++){
+                            distance2 += (xi[d] - xj[d])*(xi[d] - xj[d]);
+                        }
+                        T distance = sqrt(distance2);
+                        if(distance <= this->R){
+                            _f(this->bucketitems[p], distance);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,146 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Filter/PDEFilter.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/19
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Models/LILCSR.h"
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+#include "../../FEM/Equation/ReactionDiffusion.h"
+#include "../../FEM/Controller/Assembling.h"
+
+
+namespace PANSFEM2{
+    //**********PDE (Helmholtz) filter class**********
+    //  Nodal field psi solves (r^2*K + M)*psi = N*s with r = R/(2*sqrt(3)) and element average rho = N^T*psi/Ve,
+    //  where N_ie is integral of shape function of node i over element e.
+    //  The operator is assembled and ILU(0) factorized once, so memory is O(nodes) for any R.
+    template<class T, template<class>class SF, template<class>class IC>
+    class PDEFilter{
+public:
+        PDEFilter(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements, T _R, int _itrmax = 10000, T _eps = 1.0e-10);
+        ~PDEFilter();
+
+
+        std::vector<T> GetFilteredVariables(const std::vector<T>& _s);                                      //  Return filtered variables
+        std::vector<T> GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfdrho);    //  Return filtered sensitivities
+
+
+private:
+        const int n;                                //  Number of design variables
+        const int m;                                //  Number of nodes
+        int itrmax;                                 //  Maximum iteration of CG
+        T eps;                                      //  Convergence criterion of CG
+        std::vector<std::vector<int> > elements;    //  Elements
+        std::vector<std::vector<T> > Ne;            //  Integral of shape functions of each element
+        std::vector<T> Ve;                          //  Volume of each element
+        CSR<T> A;                                   //  r^2*K + M
+        CSR<T> M;                                   //  ILU(0) decomposition of A
+        std::vector<T> psi;                         //  Last nodal field used as initial guess
+    };
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    PDEFilter<T, SF, IC>::PDEFilter(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements, T _R, int _itrmax, T _eps) : n(_elements.size()), m(_x.size()){
+        assert(_R > T());
+        this->itrmax = _itrmax;
+        this->eps = _eps;
+        this->elements = _elements;
+        this->Ne = std::vector<std::vector<T> >(this->n);
+        this->Ve = std::vector<T>(this->n, T());
+
+        //----------Assemble r^2*K + M----------
+        T r = _R/(2.0*sqrt(3.0));
+        std::vector<std::vector<int> > nodetoglobal = std::vector<std::vector<int> >(this->m, std::vector<int>(1, 0));
+        Renumbering(nodetoglobal);
+        LILCSR<T> A = LILCSR<T>(this->m, this->m);
+        for(int e = 0; e < this->n; e++){
+            Matrix<T> Ke, Me;
+            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+            ReactionDiffusionStiffness<T, SF, IC>(Ke, nodetoelement, this->elements[e], { 0 }, _x, r*r);
+            ReactionDiffusionConsistentMass<T, SF, IC>(Me, nodetoelement, this->elements[e], { 0 }, _x);
+            Matrix<T> Ae = Ke + Me;
+            Assembling(A, Ae, nodetoglobal, nodetoelement, this->elements[e]);
+
+            //  Sum of shape functions is 1, so row sum of Me is integral of shape function
+            this->Ne[e] = std::vector<T>(this->elements[e].size(), T());
+            for(int i = 0; i < this->elements[e].size(); i++){
+                for(int j = 0; j < this->elements[e].size(); j++){
+                    this->Ne[e][i] += Me(i, j);
+                }
+                this->Ve[e] += this->Ne[e][i];
+            }
+        }
+        this->A = CSR<T>(A);
+        this->M = ILU0(this->A);
+    }
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    PDEFilter<T, SF, IC>::~PDEFilter(){}
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    std::vector<T> PDEFilter<T, SF, IC>::GetFilteredVariables(const std::vector<T>& _s){
+        assert(_s.size() == this->n);
+
+        //----------Solve (r^2*K + M)*psi = N*s----------
+        std::vector<T> b = std::vector<T>(this->m, T());
+        for(int e = 0; e < this->n; e++){
+            for(int i = 0; i < this->elements[e].size(); i++){
+                b[this->elements[e][i]] += this->Ne[e][i]*_s[e];
+            }
+        }
+        this->psi = ILU0CG(this->A, this->M, b, this->itrmax, this->eps, this->psi);
+
+        //----------Average psi on elements----------
+        std::vector<T> rho = std::vector<T>(this->n);
+#pragma omp parallel for
+        for(int e = 0; e < this->n; e++){
+            T Npsi = T();
+            for(int i = 0; i < this->elements[e].size(); i++){
+                Npsi += this->Ne[e][i]*this->psi[this->elements[e][i]];
+            }
+            rho[e] = Npsi/this->Ve[e];
+        }
+        return rho;
+    }
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    std::vector<T> PDEFilter<T, SF, IC>::GetFilteredSensitivitis(const std::vector<T>&, const std::vector<T>& _dfdrho){
+        assert(_dfdrho.size() == this->n);
+
+        //----------Solve adjoint (r^2*K + M)*lambda = N*(dfdrho/Ve) with symmetry of operator----------
+        std::vector<T> b = std::vector<T>(this->m, T());
+        for(int e = 0; e < this->n; e++){
+            for(int i = 0; i < this->elements[e].size(); i++){
+                b[this->elements[e][i]] += this->Ne[e][i]*_dfdrho[e]/this->Ve[e];
+            }
+        }
+        std::vector<T> lambda = ILU0CG(this->A, this->M, b, this->itrmax, this->eps);
+
+        //----------Get dfds = N^T*lambda----------
+        std::vector<T> dfds = std::vector<T>(this->n);
+#pragma omp parallel for
+        for(int e = 0; e < this->n; e++){
+            T Nlambda = T();
+            for(int i = 0; i < this->elements[e].size(); i++){
+                Nlambda += this->Ne[e][i]*lambda[this->elements[e][i]];
+            }
+            dfds[e] = Nlambda;
+        }
+        return dfds;
+    }
+}
@@ -10,29 +10,38 @@
 #include <vector>
 
 
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "FilterMatrix.h"
+
+
 namespace PANSFEM2{
     //**********Sensitivity filter class (Sigmund's scheme)**********
+    //  dfds = H*(s*dfds)/s with row normalized filter matrix H
     template<class T>
     class SensitivityFilter{
 public:
-        SensitivityFilter(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w);
+        SensitivityFilter(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w);
+        SensitivityFilter(const CSR<T>& _H);
         ~SensitivityFilter();
             
 
-        std::vector<T> GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfdrho);    //  Return filtered sensitivities
+        std::vector<T> GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfdrho);    //  Return filtered sensitivities
 
     
 private:
         const int n;                                //  Number of design variables 
-        std::vector<std::vector<int> > neighbors;   //  Index list of neighbor element
-        std::vector<std::vector<T> > w;             //  Weight list of neighbor element    
+        CSR<T> H;                                   //  Filter matrix
     };
 
 
     template<class T>
-    SensitivityFilter<T>::SensitivityFilter(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w) : n(_n){
-        this->neighbors = _neighbors;
-        this->w = _w;
+    SensitivityFilter<T>::SensitivityFilter(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w) : SensitivityFilter(FilterMatrix(_n, _neighbors, _w)){}
+
+
+    template<class T>
+    SensitivityFilter<T>::SensitivityFilter(const CSR<T>& _H) : n(_H.ROWS){
+        assert(_H.ROWS == _H.COLS);
+        this->H = _H;
     }
 
 
@@ -41,42 +50,50 @@ private:
 
 
     template<class T>
-    std::vector<T> SensitivityFilter<T>::GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfds){
-        std::vector<T> dfds = std::vector<T>(this->n);
+    std::vector<T> SensitivityFilter<T>::GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfds){
+        std::vector<T> sdfds = std::vector<T>(this->n);
+#pragma omp parallel for
+        for(int i = 0; i < this->n; i++){
+            sdfds[i] = _s[i]*_dfds[i];
+        }
+        std::vector<T> dfds = this->H*sdfds;
+#pragma omp parallel for
         for(int i = 0; i < this->n; i++){
-            T wsum = T();
-            for(int j = 0; j < this->neighbors[i].size(); j++){
-                dfds[i] += this->w[i][j]*_s[this->neighbors[i][j]]*_dfds[this->neighbors[i][j]];
-                wsum += this->w[i][j];
-            }
-            dfds[i] /= wsum*_s[i];       
+            dfds[i] /= _s[i];
         }
         return dfds;
     }
 
 
     //**********Sensitivity filter class (Borrvaell's scheme)**********
+    //  dfds = H*(s*dfds)/(H*s) with row normalized filter matrix H
     template<class T>
     class SensitivityFilter2{
 public:
-        SensitivityFilter2(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w);
+        SensitivityFilter2(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w);
+        SensitivityFilter2(const CSR<T>& _H);
         ~SensitivityFilter2();
             
 
-        std::vector<T> GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfdrho);    //  Return filtered sensitivities
+        std::vector<T> GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfdrho);    //  Return filtered sensitivities
 
     
 private:
         const int n;                                //  Number of design variables 
-        std::vector<std::vector<int> > neighbors;   //  Index list of neighbor element
-        std::vector<std::vector<T> > w;             //  Weight list of neighbor element    
+        CSR<T> H;                                   //  Filter matrix
+        std::vector<T> s;                           //  Design variables of Hs
+        std::vector<T> Hs;                          //  Smoothed design variables
     };
 
 
     template<class T>
-    SensitivityFilter2<T>::SensitivityFilter2(int _n, std::vector<std::vector<int> > _neighbors, std::vector<std::vector<T> > _w) : n(_n){
-        this->neighbors = _neighbors;
-        this->w = _w;
+    SensitivityFilter2<T>::SensitivityFilter2(int _n, const std::vector<std::vector<int> >& _neighbors, const std::vector<std::vector<T> >& _w) : SensitivityFilter2(FilterMatrix(_n, _neighbors, _w)){}
+
+
+    template<class T>
+    SensitivityFilter2<T>::SensitivityFilter2(const CSR<T>& _H) : n(_H.ROWS){
+        assert(_H.ROWS == _H.COLS);
+        this->H = _H;
     }
 
 
@@ -85,16 +102,21 @@ private:
 
 
     template<class T>
-    std::vector<T> SensitivityFilter2<T>::GetFilteredSensitivitis(std::vector<T> _s, std::vector<T> _dfds){
-        std::vector<T> dfds = std::vector<T>(this->n);
+    std::vector<T> SensitivityFilter2<T>::GetFilteredSensitivitis(const std::vector<T>& _s, const std::vector<T>& _dfds){
+        if(this->Hs.size() != this->n || _s != this->s){
+            this->s = _s;
+            this->H.multiply(_s, this->Hs);
+        }
+        std::vector<T> sdfds = std::vector<T>(this->n);
+#pragma omp parallel for
+        for(int i = 0; i < this->n; i++){
+            sdfds[i] = _s[i]*_dfds[i];
+        }
+        std::vector<T> dfds = this->H*sdfds;
+#pragma omp parallel for
         for(int i = 0; i < this->n; i++){
-            T wsum = T();
-            for(int j = 0; j < this->neighbors[i].size(); j++){
-                dfds[i] += this->w[i][j]*_s[this->neighbors[i][j]]*_dfds[this->neighbors[i][j]];
-                wsum += this->w[i][j]*_s[this->neighbors[i][j]];
-            }
-            dfds[i] /= wsum;       
+            dfds[i] /= this->Hs[i];
         }
         return dfds;
     }
-}
\ No newline at end of file
+}
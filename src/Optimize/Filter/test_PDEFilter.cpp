@@ -0,0 +1,55 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+
+#include "PDEFilter.h"
+#include "../../PrePost/Mesher/SquareMesh.h"
+#include "../../FEM/Controller/ShapeFunction.h"
+#include "../../FEM/Controller/GaussIntegration.h"
+
+
+using namespace PANSFEM2;
+
+
+int main(){
+    SquareMesh<double> mesh = SquareMesh<double>(20.0, 10.0, 20, 10);
+    std::vector<Vector<double> > nodes = mesh.GenerateNodes();
+    std::vector<std::vector<int> > elements = mesh.GenerateElements();
+    PDEFilter<double, ShapeFunction4Square, Gauss4Square> filter = PDEFilter<double, ShapeFunction4Square, Gauss4Square>(nodes, elements, 3.0);
+
+    //----------Constant field is kept----------
+    std::vector<double> s = std::vector<double>(elements.size(), 0.5);
+    std::vector<double> rho = filter.GetFilteredVariables(s);
+    double errorconstant = 0.0;
+    for(auto rhoi : rho){
+        errorconstant = std::max(errorconstant, fabs(rhoi - 0.5));
+    }
+
+    //----------Filtered sensitivities of f = sum w_e*rho_e agree with finite difference, which is exact since rho is linear in s----------
+    for(int i = 0; i < elements.size(); i++){
+        s[i] = 0.5 + 0.4*sin(0.3*i);
+    }
+    std::vector<double> w = std::vector<double>(elements.size());
+    for(int i = 0; i < elements.size(); i++){
+        w[i] = cos(0.1*i);
+    }
+    std::vector<double> dfds = filter.GetFilteredSensitivitis(s, w);
+    double errorsensitivity = 0.0, h = 1.0e-2;
+    for(int i : { 0, 37, 105, 199 }){
+        std::vector<double> sp = s, sm = s;
+        sp[i] += h;
+        sm[i] -= h;
+        std::vector<double> rhop = filter.GetFilteredVariables(sp), rhom = filter.GetFilteredVariables(sm);
+        double fd = 0.0;
+        for(int j = 0; j < elements.size(); j++){
+            fd += w[j]*(rhop[j] - rhom[j])/(2.0*h);
+        }
+        errorsensitivity = std::max(errorsensitivity, fabs(fd - dfds[i]));
+    }
+
+    std::cout << "Constant field error = " << errorconstant << std::endl;
+    std::cout << "Sensitivity error = " << errorsensitivity << std::endl;
+
+    return 0;
+}
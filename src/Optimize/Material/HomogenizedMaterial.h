@@ -0,0 +1,206 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Material/HomogenizedMaterial.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/19
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <map>
+#include <cassert>
+
+
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Solvers/Cholesky.h"
+#include "../../FEM/Equation/PlaneStrain.h"
+#include "../../FEM/Equation/Homogenization.h"
+#include "../../FEM/Controller/Assembling.h"
+#include "../../FEM/Controller/BoundaryCondition.h"
+
+
+namespace PANSFEM2{
+    //**********Homogenized plane strain constitutive of unit cells sharing one topology**********
+    //  Periodic numbering and skyline profile of K are made once for the topology class, so each unit cell
+    //  only fills values, and three characteristic displacements share one Cholesky decomposition.
+    //  Homogenized constitutives are cached with unit cell parameters (a, b) as key.
+    template<class T, template<class>class SF, template<class>class IC>
+    class HomogenizedMaterial{
+public:
+        HomogenizedMaterial(int _nodes, const std::vector<std::vector<int> >& _elements, const std::vector<std::pair<int, int> >& _periodic, T _E, T _V, T _t, T _volume, T _alpha = 1.0e-9);
+        ~HomogenizedMaterial();
+
+
+        Matrix<T> GetConstitutive(std::vector<Vector<T> >& _x);         //  Return homogenized constitutive of unit cell with nodes _x
+        template<class F>
+        Matrix<T> GetConstitutive(T _a, T _b, F _generatenodes);        //  Return cached homogenized constitutive of unit cell with nodes _generatenodes(_a, _b)
+        template<class F>
+        std::vector<std::vector<Matrix<T> > > GetConstitutives(const std::vector<T>& _as, const std::vector<T>& _bs, F _generatenodes);   //  Return cached homogenized constitutives of all pairs of _as and _bs
+        int CACHED() const;                                             //  Number of cached unit cells
+
+
+private:
+        T E, V, t, volume, alpha;                               //  Young modulus, Poisson ratio, thickness, volume of unit cell and weak spring
+        std::vector<std::vector<int> > elements;                //  Elements of unit cell
+        std::vector<std::vector<int> > nodetoglobal;            //  Global number of dofs with periodic condition
+        SkylineMatrix<T> K0;                                    //  Skyline profile of K with zero values
+        std::map<std::pair<T, T>, Matrix<T> > cache;            //  Homogenized constitutive of each (a, b)
+    };
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    HomogenizedMaterial<T, SF, IC>::HomogenizedMaterial(int _nodes, const std::vector<std::vector<int> >& _elements, const std::vector<std::pair<int, int> >& _periodic, T _E, T _V, T _t, T _volume, T _alpha){
+        this->E = _E;
+        this->V = _V;
+        this->t = _t;
+        this->volume = _volume;
+        this->alpha = _alpha;
+        this->elements = _elements;
+
+        //----------Number dofs with periodic condition----------
+        this->nodetoglobal = std::vector<std::vector<int> >(_nodes, std::vector<int>(2, 0));
+        int KDEGREE = SetPeriodic(this->nodetoglobal, _periodic);
+
+        //----------Make skyline profile from connectivity----------
+        std::vector<int> first = std::vector<int>(KDEGREE);
+        for(int i = 0; i < KDEGREE; i++){
+            first[i] = i;
+        }
+        for(auto& element : this->elements){
+            for(auto i : element){
+                for(auto j : element){
+                    for(auto globali : this->nodetoglobal[i]){
+                        for(auto globalj : this->nodetoglobal[j]){
+                            if(globalj < first[globali]){
+                                first[globali] = globalj;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        this->K0 = SkylineMatrix<T>(first);
+    }
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    HomogenizedMaterial<T, SF, IC>::~HomogenizedMaterial(){}
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    Matrix<T> HomogenizedMaterial<T, SF, IC>::GetConstitutive(std::vector<Vector<T> >& _x){
+        assert(_x.size() == this->nodetoglobal.size());
+
+        //----------Fill values of K and characteristic loads----------
+        SkylineMatrix<T> K = this->K0;
+        std::vector<std::vector<T> > F = std::vector<std::vector<T> >(3, std::vector<T>(K.SIZE(), T()));
+        for(auto& element : this->elements){
+            Matrix<T> Ke, Fes;
+            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+            PlaneStrainStiffness<T, SF, IC>(Ke, nodetoelement, element, { 0, 1 }, _x, this->E, this->V, this->t);
+            HomogenizePlaneStrainBodyForce<T, SF, IC>(Fes, nodetoelement, element, { 0, 1 }, _x, this->E, this->V, this->t);
+            for(int i = 0; i < Ke.ROW(); i++){
+                Ke(i, i) += this->alpha;                    //  Weak spring to prevent rigid body mode
+            }
+
+            for(int i = 0; i < element.size(); i++){
+                for(auto doui : nodetoelement[i]){
+                    int globali = this->nodetoglobal[element[i]][doui.first];
+                    for(int j = 0; j < element.size(); j++){
+                        for(auto douj : nodetoelement[j]){
+                            int globalj = this->nodetoglobal[element[j]][douj.first];
+                            if(globalj <= globali){
+                                K(globali, globalj) += Ke(doui.second, douj.second);
+                            }
+                        }
+                    }
+                    for(int k = 0; k < 3; k++){
+                        F[k][globali] += Fes(doui.second, k);
+                    }
+                }
+            }
+        }
+
+        //----------Solve three characteristic displacements with one decomposition----------
+        Cholesky(K);
+        std::vector<std::vector<Vector<T> > > chi = std::vector<std::vector<Vector<T> > >(3, std::vector<Vector<T> >(_x.size(), Vector<T>(2)));
+        for(int k = 0; k < 3; k++){
+            SolveCholesky(K, F[k]);
+            Disassembling(chi[k], F[k], this->nodetoglobal);
+        }
+
+        //----------Integrate homogenized constitutive over elements----------
+        Matrix<T> CH = Matrix<T>(3, 3);
+#pragma omp parallel
+        {
+            Matrix<T> CHthread = Matrix<T>(3, 3);
+#pragma omp for nowait
+            for(int e = 0; e < this->elements.size(); e++){
+                CHthread += HomogenizePlaneStrainConstitutive<T, SF, IC>(_x, this->elements[e], chi[0], chi[1], chi[2], this->E, this->V, this->t);
+            }
+#pragma omp critical
+            {
+                CH += CHthread;
+            }
+        }
+        CH /= this->volume;
+        return CH;
+    }
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    template<class F>
+    Matrix<T> HomogenizedMaterial<T, SF, IC>::GetConstitutive(T _a, T _b, F _generatenodes){
+        auto cached = this->cache.find(std::make_pair(_a, _b));
+        if(cached != this->cache.end()){
+            return cached->second;
+        }
+        std::vector<Vector<T> > x = _generatenodes(_a, _b);
+        Matrix<T> CH = this->GetConstitutive(x);
+        this->cache[std::make_pair(_a, _b)] = CH;
+        return CH;
+    }
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    template<class F>
+    std::vector<std::vector<Matrix<T> > > HomogenizedMaterial<T, SF, IC>::GetConstitutives(const std::vector<T>& _as, const std::vector<T>& _bs, F _generatenodes){
+        //----------List unit cells not cached yet----------
+        std::vector<std::pair<T, T> > keys;
+        for(auto a : _as){
+            for(auto b : _bs){
+                if(this->cache.find(std::make_pair(a, b)) == this->cache.end()){
+                    keys.push_back(std::make_pair(a, b));
+                }
+            }
+        }
+
+        //----------Homogenize independent unit cells in parallel----------
+        std::vector<Matrix<T> > CHs = std::vector<Matrix<T> >(keys.size());
+        int kend = keys.size();
+#pragma omp parallel for schedule(dynamic)
+        for(int k = 0; k < kend; k++){
+            std::vector<Vector<T> > x = _generatenodes(keys[k].first, keys[k].second);
+            CHs[k] = this->GetConstitutive(x);
+        }
+        for(int k = 0; k < keys.size(); k++){
+            this->cache[keys[k]] = CHs[k];
+        }
+
+        std::vector<std::vector<Matrix<T> > > CH = std::vector<std::vector<Matrix<T> > >(_as.size(), std::vector<Matrix<T> >(_bs.size()));
+        for(int i = 0; i < _as.size(); i++){
+            for(int j = 0; j < _bs.size(); j++){
+                CH[i][j] = this->cache[std::make_pair(_as[i], _bs[j])];
+            }
+        }
+        return CH;
+    }
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    int HomogenizedMaterial<T, SF, IC>::CACHED() const {
+        return this->cache.size();
+    }
+}
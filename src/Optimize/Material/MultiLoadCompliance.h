@@ -0,0 +1,108 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Material/MultiLoadCompliance.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/19
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cassert>
+
+
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Models/LILCSR.h"
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+#include "../../FEM/Controller/Assembling.h"
+#include "../../FEM/Controller/BoundaryCondition.h"
+#include "SIMP.h"
+
+
+namespace PANSFEM2{
+    //**********Weighted sum of compliances of load cases sharing one stiffness matrix**********
+    //  K is assembled once per call, all load cases are solved together with ScalingMultiCG,
+    //  and sensitivities of all load cases are accumulated in one pass over elements.
+    template<class T>
+    class MultiLoadCompliance{
+public:
+        MultiLoadCompliance(SIMP<T>& _simp, int _nodes, int _dofs, const std::vector<std::pair<std::pair<int, int>, T> >& _ufixed, const std::vector<std::vector<std::pair<std::pair<int, int>, T> > >& _qfixeds, const std::vector<T>& _weights = std::vector<T>(), int _itrmax = 100000, T _eps = 1.0e-10);
+        ~MultiLoadCompliance();
+
+
+        std::vector<std::vector<Vector<T> > > u;        //  Displacements of each load case at last call
+
+
+        int LOADS() const;                              //  Number of load cases
+        T GetComplianceSensitivities(const std::vector<T>& _rho, std::vector<T>& _dfdrho);   //  Return weighted sum of compliances and set its sensitivities
+
+
+private:
+        SIMP<T>& simp;                                  //  Material with reference stiffness matrices
+        int itrmax;                                     //  Maximum iteration of CG
+        T eps;                                          //  Convergence criterion of CG
+        int KDEGREE;                                    //  Number of free dofs
+        std::vector<std::vector<int> > nodetoglobal;    //  Global number of dofs
+        std::vector<Vector<T> > ufixed;                 //  Displacements with Dirichlet values
+        std::vector<std::vector<T> > Q;                 //  Global load vector of each load case
+        std::vector<T> weights;                         //  Weight of each load case
+        std::vector<std::vector<T> > results;           //  Last solutions used as initial guess
+    };
+
+
+    template<class T>
+    MultiLoadCompliance<T>::MultiLoadCompliance(SIMP<T>& _simp, int _nodes, int _dofs, const std::vector<std::pair<std::pair<int, int>, T> >& _ufixed, const std::vector<std::vector<std::pair<std::pair<int, int>, T> > >& _qfixeds, const std::vector<T>& _weights, int _itrmax, T _eps) : simp(_simp){
+        assert(_weights.empty() || _weights.size() == _qfixeds.size());
+        this->itrmax = _itrmax;
+        this->eps = _eps;
+        this->weights = _weights.empty() ? std::vector<T>(_qfixeds.size(), 1.0) : _weights;
+
+        //----------Number dofs once since Dirichlet conditions are common----------
+        this->ufixed = std::vector<Vector<T> >(_nodes, Vector<T>(_dofs));
+        this->nodetoglobal = std::vector<std::vector<int> >(_nodes, std::vector<int>(_dofs, 0));
+        SetDirichlet(this->ufixed, this->nodetoglobal, _ufixed);
+        this->KDEGREE = Renumbering(this->nodetoglobal);
+
+        this->Q = std::vector<std::vector<T> >(_qfixeds.size(), std::vector<T>(this->KDEGREE, T()));
+        for(int l = 0; l < _qfixeds.size(); l++){
+            Assembling(this->Q[l], _qfixeds[l], this->nodetoglobal);
+        }
+    }
+
+
+    template<class T>
+    MultiLoadCompliance<T>::~MultiLoadCompliance(){}
+
+
+    template<class T>
+    int MultiLoadCompliance<T>::LOADS() const{
+        return this->Q.size();
+    }
+
+
+    template<class T>
+    T MultiLoadCompliance<T>::GetComplianceSensitivities(const std::vector<T>& _rho, std::vector<T>& _dfdrho){
+        //----------Assemble K once for all load cases----------
+        std::vector<Vector<T> > u0 = this->ufixed;
+        LILCSR<T> K = LILCSR<T>(this->KDEGREE, this->KDEGREE);
+        std::vector<T> F = std::vector<T>(this->KDEGREE, T());
+        this->simp.AssemblingStiffness(K, F, u0, this->nodetoglobal, _rho);
+        CSR<T> Kmod = CSR<T>(K);
+
+        //----------Solve all load cases together----------
+        std::vector<std::vector<T> > B = this->Q;
+        for(auto& Bl : B){
+            xexpay(Bl, 1.0, F);
+        }
+        this->results = ScalingMultiCG(Kmod, GetDiagonal(Kmod), B, this->itrmax, this->eps, this->results);
+
+        this->u = std::vector<std::vector<Vector<T> > >(this->LOADS(), u0);
+        for(int l = 0; l < this->LOADS(); l++){
+            Disassembling(this->u[l], this->results[l], this->nodetoglobal);
+        }
+
+        //----------Get compliance and sensitivities in one pass over elements----------
+        return this->simp.GetComplianceSensitivities(this->u, this->weights, _rho, _dfdrho);
+    }
+}
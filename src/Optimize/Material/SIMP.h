@@ -0,0 +1,363 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Material/SIMP.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/18
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <functional>
+#include <unordered_map>
+#include <omp.h>
+
+
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Models/LILCSR.h"
+#include "../../FEM/Controller/Assembling.h"
+
+
+namespace PANSFEM2{
+    //**********SIMP interpolation with reference stiffness matrices**********
+    //  Unit element matrices Ke0 (E = 1) are made only once for each distinct element shape.
+    //  Shapes are identified by hashing the relative nodal coordinates of elements.
+    template<class T>
+    class SIMP{
+public:
+        SIMP();
+        ~SIMP();
+        template<class F>
+        SIMP(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements, F _kernel, T _E0, T _E1, T _p, T _eps = 1.0e-8);
+
+
+        T E(T _rho) const;                                      //  Return interpolated Young modulus
+        T dEdrho(T _rho) const;                                 //  Return derivative of interpolated Young modulus
+        int SHAPES() const;                                     //  Return number of distinct element shapes
+        void AssemblingStiffness(LILCSR<T>& _K, std::vector<T>& _F, std::vector<Vector<T> >& _u, const std::vector<std::vector<int> >& _nodetoglobal, const std::vector<T>& _rho);
+        std::vector<T> GetStrainEnergies(std::vector<Vector<T> >& _u);                                          //  Return ue^T*Ke0*ue of all elements
+        std::vector<T> GetMutualEnergies(std::vector<Vector<T> >& _u, std::vector<Vector<T> >& _lambda);        //  Return lambdae^T*Ke0*ue of all elements
+        T GetComplianceSensitivities(std::vector<Vector<T> >& _u, const std::vector<T>& _rho, std::vector<T>& _dfdrho);    //  Return compliance and set its sensitivities
+        T GetComplianceSensitivities(std::vector<std::vector<Vector<T> > >& _us, const std::vector<T>& _weights, const std::vector<T>& _rho, std::vector<T>& _dfdrho);   //  Return weighted sum of compliances of load cases and set its sensitivities
+        void GetAdjointSensitivities(std::vector<Vector<T> >& _u, std::vector<Vector<T> >& _lambda, const std::vector<T>& _rho, std::vector<T>& _dfdrho);   //  Set -lambda^T*dK/drho*u with adjoint lambda of K*lambda = df/du
+        void GetReactionForce(std::vector<Vector<T> >& _r, std::vector<Vector<T> >& _u, const std::vector<T>& _rho);
+
+
+private:
+        struct KeyHash{
+            std::size_t operator()(const std::vector<long long>& _key) const{
+                std::size_t seed = _key.size();
+                for(auto keyi : _key){
+                    seed ^= std::hash<long long>()(keyi) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+                }
+                return seed;
+            }
+        };
+
+
+        T E0, E1, p;                                                                        //  Parameters of SIMP
+        std::vector<std::vector<int> > elements;                                            //  Elements
+        std::vector<int> shapes;                                                            //  Shape index of each element
+        std::vector<Matrix<T> > Ke0;                                                        //  Unit element matrix of each shape
+        std::vector<std::vector<T> > ke0;                                                   //  Row-major values of Ke0
+        std::vector<std::vector<std::vector<std::pair<int, int> > > > nodetoelements;       //  Node to element of each shape
+    };
+
+
+    template<class T>
+    SIMP<T>::SIMP(){}
+
+
+    template<class T>
+    SIMP<T>::~SIMP(){}
+
+
+    template<class T>
+    template<class F>
+    SIMP<T>::SIMP(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements, F _kernel, T _E0, T _E1, T _p, T _eps){
+        this->E0 = _E0;
+        this->E1 = _E1;
+        this->p = _p;
+        this->elements = _elements;
+        this->shapes = std::vector<int>(_elements.size());
+
+        //----------Get tolerance of coordinates----------
+        T length = T();
+        for(auto& element : _elements){
+            for(int i = 1; i < element.size(); i++){
+                length = std::max(length, (_x[element[i]] - _x[element[0]]).Norm());
+            }
+        }
+        T tolerance = _eps*length;
+
+        //----------Classify elements by relative coordinates----------
+        std::unordered_map<std::vector<long long>, int, KeyHash> shapelist;
+        for(int i = 0; i < _elements.size(); i++){
+            std::vector<long long> key;
+            for(int j = 1; j < _elements[i].size(); j++){
+                Vector<T> dx = _x[_elements[i][j]] - _x[_elements[i][0]];
+                for(int k = 0; k < dx.SIZE(); k++){
+                    key.push_back(llround(dx(k)/tolerance));
+                }
+            }
+
+            auto shape = shapelist.find(key);
+            if(shape != shapelist.end()){
+                this->shapes[i] = shape->second;
+            } else {
+                //----------Make unit element matrix of new shape----------
+                Matrix<T> Ke;
+                std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+                _kernel(Ke, nodetoelement, _elements[i]);
+                assert(Ke.ROW() == Ke.COL());
+
+                std::vector<T> ke = std::vector<T>(Ke.ROW()*Ke.COL());
+                for(int j = 0; j < Ke.ROW(); j++){
+                    for(int k = 0; k < Ke.COL(); k++){
+                        ke[j*Ke.COL() + k] = Ke(j, k);
+                    }
+                }
+
+                this->shapes[i] = this->Ke0.size();
+                shapelist[key] = this->Ke0.size();
+                this->Ke0.push_back(Ke);
+                this->ke0.push_back(ke);
+                this->nodetoelements.push_back(nodetoelement);
+            }
+        }
+    }
+
+
+    template<class T>
+    T SIMP<T>::E(T _rho) const {
+        return this->E1*pow(_rho, this->p) + this->E0*(1.0 - pow(_rho, this->p));
+    }
+
+
+    template<class T>
+    T SIMP<T>::dEdrho(T _rho) const {
+        return this->p*(this->E1 - this->E0)*pow(_rho, this->p - 1.0);
+    }
+
+
+    template<class T>
+    int SIMP<T>::SHAPES() const {
+        return this->Ke0.size();
+    }
+
+
+    template<class T>
+    void SIMP<T>::AssemblingStiffness(LILCSR<T>& _K, std::vector<T>& _F, std::vector<Vector<T> >& _u, const std::vector<std::vector<int> >& _nodetoglobal, const std::vector<T>& _rho){
+        assert(_rho.size() == this->elements.size());
+        int nthreads = omp_get_max_threads();
+        std::vector<LILCSR<T> > Kthreads = std::vector<LILCSR<T> >(nthreads);
+        std::vector<std::vector<T> > Fthreads = std::vector<std::vector<T> >(nthreads);
+
+        //----------Scatter Ke0 scaled by E(rho) into buffer of each thread----------
+#pragma omp parallel
+        {
+            LILCSR<T>& Kthread = Kthreads[omp_get_thread_num()];
+            std::vector<T>& Fthread = Fthreads[omp_get_thread_num()];
+            Kthread = LILCSR<T>(_K.ROWS, _K.COLS);
+            Fthread = std::vector<T>(_F.size(), T());
+#pragma omp for
+            for(int i = 0; i < this->elements.size(); i++){
+                const std::vector<int>& element = this->elements[i];
+                const std::vector<std::vector<std::pair<int, int> > >& nodetoelement = this->nodetoelements[this->shapes[i]];
+                const std::vector<T>& ke = this->ke0[this->shapes[i]];
+                int n = this->Ke0[this->shapes[i]].COL();
+                T Ei = this->E(_rho[i]);
+
+                for(int j = 0; j < element.size(); j++){
+                    for(auto douj : nodetoelement[j]){
+                        int globalj = _nodetoglobal[element[j]][douj.first];
+                        if(globalj != -1){
+                            for(int k = 0; k < element.size(); k++){
+                                for(auto douk : nodetoelement[k]){
+                                    int globalk = _nodetoglobal[element[k]][douk.first];
+                                    T kjk = Ei*ke[douj.second*n + douk.second];
+                                    if(globalk != -1){
+                                        Kthread.set(globalj, globalk, Kthread.get(globalj, globalk) + kjk);
+                                    } else {
+                                        Fthread[globalj] -= kjk*_u[element[k]](douk.first);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        //----------Sum buffers in thread order for reproducibility----------
+#pragma omp parallel for
+        for(int i = 0; i < _K.ROWS; i++){
+            for(int j = 0; j < nthreads; j++){
+                if(Kthreads[j].ROWS == _K.ROWS){
+                    _K.add(Kthreads[j], i, i + 1);
+                    _F[i] += Fthreads[j][i];
+                }
+            }
+        }
+    }
+
+
+    template<class T>
+    std::vector<T> SIMP<T>::GetStrainEnergies(std::vector<Vector<T> >& _u){
+        return this->GetMutualEnergies(_u, _u);
+    }
+
+
+    template<class T>
+    std::vector<T> SIMP<T>::GetMutualEnergies(std::vector<Vector<T> >& _u, std::vector<Vector<T> >& _lambda){
+        std::vector<T> lambdaKu = std::vector<T>(this->elements.size());
+
+#pragma omp parallel
+        {
+            std::vector<T> ue, lambdae;
+#pragma omp for
+            for(int i = 0; i < this->elements.size(); i++){
+                const std::vector<std::vector<std::pair<int, int> > >& nodetoelement = this->nodetoelements[this->shapes[i]];
+                const std::vector<T>& ke = this->ke0[this->shapes[i]];
+                int n = this->Ke0[this->shapes[i]].ROW();
+
+                ue.resize(n);
+                lambdae.resize(n);
+                for(int j = 0; j < nodetoelement.size(); j++){
+                    for(auto dou : nodetoelement[j]){
+                        ue[dou.second] = _u[this->elements[i][j]](dou.first);
+                        lambdae[dou.second] = _lambda[this->elements[i][j]](dou.first);
+                    }
+                }
+
+                T value = T();
+                for(int j = 0; j < n; j++){
+                    T kuj = T();
+#pragma omp simd reduction(+:kuj)
+                    for(int k = 0; k < n; k++){
+                        kuj += ke[j*n + k]*ue[k];
+                    }
+                    value += lambdae[j]*kuj;
+                }
+                lambdaKu[i] = value;
+            }
+        }
+
+        return lambdaKu;
+    }
+
+
+    template<class T>
+    T SIMP<T>::GetComplianceSensitivities(std::vector<Vector<T> >& _u, const std::vector<T>& _rho, std::vector<T>& _dfdrho){
+        assert(_rho.size() == this->elements.size());
+        std::vector<T> uKu = this->GetStrainEnergies(_u);
+        _dfdrho = std::vector<T>(this->elements.size());
+
+        T f = T();
+#pragma omp parallel for reduction(+:f)
+        for(int i = 0; i < this->elements.size(); i++){
+            f += this->E(_rho[i])*uKu[i];
+            _dfdrho[i] = -this->dEdrho(_rho[i])*uKu[i];
+        }
+        return f;
+    }
+
+
+    template<class T>
+    T SIMP<T>::GetComplianceSensitivities(std::vector<std::vector<Vector<T> > >& _us, const std::vector<T>& _weights, const std::vector<T>& _rho, std::vector<T>& _dfdrho){
+        assert(_rho.size() == this->elements.size() && _weights.size() == _us.size());
+        int nl = _us.size();
+        _dfdrho = std::vector<T>(this->elements.size());
+
+        //----------Get sum of wl*ue^T*Ke0*ue over load cases in one pass over elements----------
+        T f = T();
+#pragma omp parallel reduction(+:f)
+        {
+            std::vector<T> ue, kue;
+#pragma omp for
+            for(int i = 0; i < this->elements.size(); i++){
+                const std::vector<std::vector<std::pair<int, int> > >& nodetoelement = this->nodetoelements[this->shapes[i]];
+                const std::vector<T>& ke = this->ke0[this->shapes[i]];
+                int n = this->Ke0[this->shapes[i]].ROW();
+
+                //  Displacements of all load cases are interleaved as ue[k*nl + l]
+                ue.resize(n*nl);
+                kue.resize(nl);
+                for(int j = 0; j < nodetoelement.size(); j++){
+                    for(auto dou : nodetoelement[j]){
+                        for(int l = 0; l < nl; l++){
+                            ue[dou.second*nl + l] = _us[l][this->elements[i][j]](dou.first);
+                        }
+                    }
+                }
+
+                T value = T();
+                for(int j = 0; j < n; j++){
+                    std::fill(kue.begin(), kue.end(), T());
+                    for(int k = 0; k < n; k++){
+                        T kejk = ke[j*n + k];
+#pragma omp simd
+                        for(int l = 0; l < nl; l++){
+                            kue[l] += kejk*ue[k*nl + l];
+                        }
+                    }
+                    for(int l = 0; l < nl; l++){
+                        value += _weights[l]*ue[j*nl + l]*kue[l];
+                    }
+                }
+                f += this->E(_rho[i])*value;
+                _dfdrho[i] = -this->dEdrho(_rho[i])*value;
+            }
+        }
+        return f;
+    }
+
+
+    template<class T>
+    void SIMP<T>::GetAdjointSensitivities(std::vector<Vector<T> >& _u, std::vector<Vector<T> >& _lambda, const std::vector<T>& _rho, std::vector<T>& _dfdrho){
+        assert(_rho.size() == this->elements.size());
+        std::vector<T> lambdaKu = this->GetMutualEnergies(_u, _lambda);
+        _dfdrho = std::vector<T>(this->elements.size());
+
+#pragma omp parallel for
+        for(int i = 0; i < this->elements.size(); i++){
+            _dfdrho[i] = -this->dEdrho(_rho[i])*lambdaKu[i];
+        }
+    }
+
+
+    template<class T>
+    void SIMP<T>::GetReactionForce(std::vector<Vector<T> >& _r, std::vector<Vector<T> >& _u, const std::vector<T>& _rho){
+        assert(_rho.size() == this->elements.size());
+        for(auto& ri : _r){
+            ri *= T();
+        }
+
+        for(int i = 0; i < this->elements.size(); i++){
+            const std::vector<std::vector<std::pair<int, int> > >& nodetoelement = this->nodetoelements[this->shapes[i]];
+            const std::vector<T>& ke = this->ke0[this->shapes[i]];
+            int n = this->Ke0[this->shapes[i]].ROW();
+
+            std::vector<T> ue = std::vector<T>(n);
+            for(int j = 0; j < nodetoelement.size(); j++){
+                for(auto dou : nodetoelement[j]){
+                    ue[dou.second] = _u[this->elements[i][j]](dou.first);
+                }
+            }
+
+            T Ei = this->E(_rho[i]);
+            for(int j = 0; j < nodetoelement.size(); j++){
+                for(auto dou : nodetoelement[j]){
+                    T kuj = T();
+                    for(int k = 0; k < n; k++){
+                        kuj += ke[dou.second*n + k]*ue[k];
+                    }
+                    _r[this->elements[i][j]](dou.first) += Ei*kuj;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,275 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Material/TabulatedMaterial.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/19
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cassert>
+
+
+#include "../../LinearAlgebra/Models/Matrix.h"
+
+
+namespace PANSFEM2{
+    //**********Plane constitutive tabulated on (a, b) grid and rotated by theta**********
+    //  CH(a, b) is interpolated with tensor product of natural cubic splines, whose weights are linear in tabulated values,
+    //  and rotated as R^T*CH*R analytically, so derivatives with respect to a, b and theta are exact for the interpolant.
+    //  Table can be saved to and loaded from binary file, so unit cell analyses run once for each microstructure family.
+    //  The file keeps grid and material parameters of the unit cell analyses, and a table made with other ones is rejected on loading.
+    template<class T>
+    class TabulatedMaterial{
+public:
+        TabulatedMaterial();
+        ~TabulatedMaterial();
+        TabulatedMaterial(const std::vector<T>& _as, const std::vector<T>& _bs, const std::vector<std::vector<Matrix<T> > >& _CH);
+
+
+        void GetConstitutives(const std::vector<T>& _a, const std::vector<T>& _b, const std::vector<T>& _theta, std::vector<Matrix<T> >& _C) const;     //  Set constitutives of all elements
+        void GetConstitutives(const std::vector<T>& _a, const std::vector<T>& _b, const std::vector<T>& _theta, std::vector<Matrix<T> >& _C, std::vector<Matrix<T> >& _dCda, std::vector<Matrix<T> >& _dCdb, std::vector<Matrix<T> >& _dCdtheta) const;   //  Set constitutives and their derivatives of all elements
+        bool ExportToBinary(std::string _fname, const std::vector<T>& _parameters = std::vector<T>()) const;    //  Save table with grid and material parameters to binary file
+        bool ImportFromBinary(std::string _fname, const std::vector<T>& _as, const std::vector<T>& _bs, const std::vector<T>& _parameters = std::vector<T>());  //  Load table only when grid and material parameters match
+
+
+private:
+        std::vector<T> as, bs;                              //  Grid of a and b
+        std::vector<std::vector<T> > Sa, Sb;                //  Second derivatives of cardinal splines at grid
+        std::vector<T> values;                              //  Values of CH(a_n, b_m) as values[(n*bs.size() + m)*9 + 3*i + j]
+        static const int MAGIC = 0x31424154;                //  Tag of binary file format
+
+
+        void MakeSplines();
+        static std::vector<std::vector<T> > CardinalSplines(const std::vector<T>& _xs);
+        static void Weights(const std::vector<T>& _xs, const std::vector<std::vector<T> >& _S, T _x, std::vector<T>& _w, std::vector<T>& _dwdx);
+        void Interpolate(T _a, T _b, Matrix<T>& _C, Matrix<T>& _dCda, Matrix<T>& _dCdb) const;
+    };
+
+
+    template<class T>
+    TabulatedMaterial<T>::TabulatedMaterial(){}
+
+
+    template<class T>
+    TabulatedMaterial<T>::~TabulatedMaterial(){}
+
+
+    template<class T>
+    TabulatedMaterial<T>::TabulatedMaterial(const std::vector<T>& _as, const std::vector<T>& _bs, const std::vector<std::vector<Matrix<T> > >& _CH){
+        assert(_as.size() >= 2 && _bs.size() >= 2 && _CH.size() == _as.size());
+        this->as = _as;
+        this->bs = _bs;
+        this->values = std::vector<T>(_as.size()*_bs.size()*9);
+        for(int n = 0; n < _as.size(); n++){
+            assert(_CH[n].size() == _bs.size());
+            for(int m = 0; m < _bs.size(); m++){
+                assert(_CH[n][m].ROW() == 3 && _CH[n][m].COL() == 3);
+                for(int i = 0; i < 3; i++){
+                    for(int j = 0; j < 3; j++){
+                        this->values[(n*_bs.size() + m)*9 + 3*i + j] = _CH[n][m](i, j);
+                    }
+                }
+            }
+        }
+        this->MakeSplines();
+    }
+
+
+    template<class T>
+    void TabulatedMaterial<T>::MakeSplines(){
+        this->Sa = CardinalSplines(this->as);
+        this->Sb = CardinalSplines(this->bs);
+    }
+
+
+    //----------Second derivatives S[k][n] at x_k of natural cubic spline through unit value at x_n----------
+    template<class T>
+    std::vector<std::vector<T> > TabulatedMaterial<T>::CardinalSplines(const std::vector<T>& _xs){
+        int N = _xs.size();
+        std::vector<std::vector<T> > S = std::vector<std::vector<T> >(N, std::vector<T>(N, T()));
+        for(int n = 0; n < N; n++){
+            //----------Solve tridiagonal system with Thomas algorithm----------
+            std::vector<T> c = std::vector<T>(N, T()), d = std::vector<T>(N, T());
+            for(int k = 1; k < N - 1; k++){
+                T h0 = _xs[k] - _xs[k - 1], h1 = _xs[k + 1] - _xs[k];
+                T rhs = 6.0*(((k + 1 == n) - (k == n))/h1 - ((k == n) - (k - 1 == n))/h0);
+                T denominator = 2.0*(h0 + h1) - h0*c[k - 1];
+                c[k] = h1/denominator;
+                d[k] = (rhs - h0*d[k - 1])/denominator;
+            }
+            for(int k = N - 2; k > 0; k--){
+                S[k][n] = d[k] - c[k]*S[k + 1][n];
+            }
+        }
+        return S;
+    }
+
+
+    template<class T>
+    void TabulatedMaterial<T>::Weights(const std::vector<T>& _xs, const std::vector<std::vector<T> >& _S, T _x, std::vector<T>& _w, std::vector<T>& _dwdx){
+        int N = _xs.size();
+        int k = 0;
+        while(k < N - 2 && _x > _xs[k + 1]){
+            k++;
+        }
+        T h = _xs[k + 1] - _xs[k];
+        T A = (_xs[k + 1] - _x)/h, B = (_x - _xs[k])/h;
+        T cA = (A*A*A - A)*h*h/6.0, cB = (B*B*B - B)*h*h/6.0;
+        T dcA = -(3.0*A*A - 1.0)*h/6.0, dcB = (3.0*B*B - 1.0)*h/6.0;
+        for(int n = 0; n < N; n++){
+            _w[n] = cA*_S[k][n] + cB*_S[k + 1][n];
+            _dwdx[n] = dcA*_S[k][n] + dcB*_S[k + 1][n];
+        }
+        _w[k] += A;
+        _w[k + 1] += B;
+        _dwdx[k] -= 1.0/h;
+        _dwdx[k + 1] += 1.0/h;
+    }
+
+
+    template<class T>
+    void TabulatedMaterial<T>::Interpolate(T _a, T _b, Matrix<T>& _C, Matrix<T>& _dCda, Matrix<T>& _dCdb) const {
+        int na = this->as.size(), nb = this->bs.size();
+        std::vector<T> wa = std::vector<T>(na), dwa = std::vector<T>(na), wb = std::vector<T>(nb), dwb = std::vector<T>(nb);
+        Weights(this->as, this->Sa, _a, wa, dwa);
+        Weights(this->bs, this->Sb, _b, wb, dwb);
+
+        T C[9] = {}, Ca[9] = {}, Cb[9] = {};
+        for(int n = 0; n < na; n++){
+            //----------Contract over b first, then over a----------
+            T Cn[9] = {}, Cbn[9] = {};
+            const T* valuesn = &this->values[n*nb*9];
+            for(int m = 0; m < nb; m++){
+                for(int q = 0; q < 9; q++){
+                    Cn[q] += wb[m]*valuesn[m*9 + q];
+                    Cbn[q] += dwb[m]*valuesn[m*9 + q];
+                }
+            }
+            for(int q = 0; q < 9; q++){
+                C[q] += wa[n]*Cn[q];
+                Ca[q] += dwa[n]*Cn[q];
+                Cb[q] += wa[n]*Cbn[q];
+            }
+        }
+
+        _C = Matrix<T>(3, 3);
+        _dCda = Matrix<T>(3, 3);
+        _dCdb = Matrix<T>(3, 3);
+        for(int i = 0; i < 3; i++){
+            for(int j = 0; j < 3; j++){
+                _C(i, j) = C[3*i + j];
+                _dCda(i, j) = Ca[3*i + j];
+                _dCdb(i, j) = Cb[3*i + j];
+            }
+        }
+    }
+
+
+    template<class T>
+    void TabulatedMaterial<T>::GetConstitutives(const std::vector<T>& _a, const std::vector<T>& _b, const std::vector<T>& _theta, std::vector<Matrix<T> >& _C) const {
+        std::vector<Matrix<T> > dCda, dCdb, dCdtheta;
+        this->GetConstitutives(_a, _b, _theta, _C, dCda, dCdb, dCdtheta);
+    }
+
+
+    template<class T>
+    void TabulatedMaterial<T>::GetConstitutives(const std::vector<T>& _a, const std::vector<T>& _b, const std::vector<T>& _theta, std::vector<Matrix<T> >& _C, std::vector<Matrix<T> >& _dCda, std::vector<Matrix<T> >& _dCdb, std::vector<Matrix<T> >& _dCdtheta) const {
+        assert(_a.size() == _b.size() && _a.size() == _theta.size());
+        int ne = _a.size();
+        _C = std::vector<Matrix<T> >(ne);
+        _dCda = std::vector<Matrix<T> >(ne);
+        _dCdb = std::vector<Matrix<T> >(ne);
+        _dCdtheta = std::vector<Matrix<T> >(ne);
+
+#pragma omp parallel for
+        for(int e = 0; e < ne; e++){
+            Matrix<T> C, dCda, dCdb;
+            this->Interpolate(_a[e], _b[e], C, dCda, dCdb);
+
+            //----------Rotate with theta----------
+            T c = cos(_theta[e]), s = sin(_theta[e]), c2 = cos(2.0*_theta[e]), s2 = sin(2.0*_theta[e]);
+            Matrix<T> R = Matrix<T>(3, 3);
+            R(0, 0) = c*c;          R(0, 1) = s*s;          R(0, 2) = c*s;
+            R(1, 0) = s*s;          R(1, 1) = c*c;          R(1, 2) = -s*c;
+            R(2, 0) = -2.0*c*s;     R(2, 1) = 2.0*s*c;      R(2, 2) = c*c - s*s;
+            Matrix<T> dR = Matrix<T>(3, 3);
+            dR(0, 0) = -s2;         dR(0, 1) = s2;          dR(0, 2) = c2;
+            dR(1, 0) = s2;          dR(1, 1) = -s2;         dR(1, 2) = -c2;
+            dR(2, 0) = -2.0*c2;     dR(2, 1) = 2.0*c2;      dR(2, 2) = -2.0*s2;
+            Matrix<T> RT = R.Transpose();
+            Matrix<T> CR = C*R;
+
+            _C[e] = RT*CR;
+            _dCda[e] = RT*dCda*R;
+            _dCdb[e] = RT*dCdb*R;
+            _dCdtheta[e] = dR.Transpose()*CR + RT*C*dR;
+        }
+    }
+
+
+    template<class T>
+    bool TabulatedMaterial<T>::ExportToBinary(std::string _fname, const std::vector<T>& _parameters) const {
+        std::ofstream ofs(_fname, std::ios::binary);
+        if(!ofs.is_open()){
+            std::cout << "Tabulated material file " << _fname << " open error!" << std::endl;
+            return false;
+        }
+
+        int header[5] = { TabulatedMaterial<T>::MAGIC, (int)sizeof(T), (int)this->as.size(), (int)this->bs.size(), (int)_parameters.size() };
+        ofs.write((const char*)header, sizeof(header));
+        ofs.write((const char*)this->as.data(), sizeof(T)*this->as.size());
+        ofs.write((const char*)this->bs.data(), sizeof(T)*this->bs.size());
+        ofs.write((const char*)_parameters.data(), sizeof(T)*_parameters.size());
+        ofs.write((const char*)this->values.data(), sizeof(T)*this->values.size());
+        return ofs.good();
+    }
+
+
+    template<class T>
+    bool TabulatedMaterial<T>::ImportFromBinary(std::string _fname, const std::vector<T>& _as, const std::vector<T>& _bs, const std::vector<T>& _parameters){
+        std::ifstream ifs(_fname, std::ios::binary);
+        if(!ifs.is_open()){
+            std::cout << "Tabulated material file " << _fname << " open error!" << std::endl;
+            return false;
+        }
+
+        //----------Check header----------
+        int header[5];
+        ifs.read((char*)header, sizeof(header));
+        if(!ifs.good() || header[0] != TabulatedMaterial<T>::MAGIC || header[1] != (int)sizeof(T)){
+            std::cout << "Tabulated material file " << _fname << " format error!" << std::endl;
+            return false;
+        }
+        if(header[2] != (int)_as.size() || header[3] != (int)_bs.size() || header[4] != (int)_parameters.size()){
+            std::cout << "Tabulated material file " << _fname << " is made with other grid or parameters" << std::endl;
+            return false;
+        }
+
+        //----------Check grid and material parameters----------
+        std::vector<T> as = std::vector<T>(header[2]), bs = std::vector<T>(header[3]), parameters = std::vector<T>(header[4]), values = std::vector<T>(header[2]*header[3]*9);
+        ifs.read((char*)as.data(), sizeof(T)*as.size());
+        ifs.read((char*)bs.data(), sizeof(T)*bs.size());
+        ifs.read((char*)parameters.data(), sizeof(T)*parameters.size());
+        ifs.read((char*)values.data(), sizeof(T)*values.size());
+        if(!ifs.good()){
+            std::cout << "Tabulated material file " << _fname << " format error!" << std::endl;
+            return false;
+        }
+        if(as != _as || bs != _bs || parameters != _parameters){
+            std::cout << "Tabulated material file " << _fname << " is made with other grid or parameters" << std::endl;
+            return false;
+        }
+
+        this->as = as;
+        this->bs = bs;
+        this->values = values;
+        this->MakeSplines();
+        return true;
+    }
+}
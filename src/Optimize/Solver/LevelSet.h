@@ -0,0 +1,131 @@
+//*****************************************************************************
+//  Title       :   src/Optimize/Solver/LevelSet.h
+//  Author      :   Tanabe Yuta
+//  Date        :   2026/10/19
+//  Copyright   :   (C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Models/LILCSR.h"
+#include "../../LinearAlgebra/Models/CSR.h"
+#include "../../LinearAlgebra/Solvers/CG.h"
+#include "../../FEM/Equation/ReactionDiffusion.h"
+#include "../../FEM/Controller/Assembling.h"
+#include "../../FEM/Controller/BoundaryCondition.h"
+
+
+namespace PANSFEM2{
+    //**********Level set function update with reaction-diffusion equation**********
+    //  (M/dt + K)*phi_new = M/dt*phi + C*M*(TD - lambda), where M is consistent mass and K is diffusion with _D.
+    //  Reaction term is linear in nodal TD, so it is integrated exactly by M and nothing is reassembled after construction.
+    //  M/dt + K is assembled and ILU(0) factorized once, and phi of previous step is initial guess of CG.
+    template<class T, template<class>class SF, template<class>class IC>
+    class LevelSet{
+public:
+        LevelSet(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements, const std::vector<std::pair<std::pair<int, int>, T> >& _phifixed, T _D, T _dt, int _itrmax = 100000, T _eps = 1.0e-10);
+        ~LevelSet();
+
+
+        void UpdateLevelSet(std::vector<Vector<T> >& _phi, const std::vector<Vector<T> >& _TD, T _C, T _lambda);    //  Update level set function with nodal topological derivatives _TD
+
+
+private:
+        const int m;                                            //  Number of nodes
+        int itrmax;                                             //  Maximum iteration of CG
+        T eps;                                                  //  Convergence criterion of CG
+        std::vector<std::pair<std::pair<int, int>, T> > phifixed;   //  Dirichlet condition of phi
+        std::vector<std::vector<int> > nodetoglobal;            //  Global number of free nodes
+        CSR<T> A;                                               //  M/dt + K of free nodes
+        CSR<T> ILU;                                             //  ILU(0) decomposition of A
+        CSR<T> B;                                               //  Rows of free nodes of M/dt, minus A for columns of fixed nodes
+        CSR<T> MF;                                              //  Rows of free nodes of M
+    };
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    LevelSet<T, SF, IC>::LevelSet(std::vector<Vector<T> >& _x, const std::vector<std::vector<int> >& _elements, const std::vector<std::pair<std::pair<int, int>, T> >& _phifixed, T _D, T _dt, int _itrmax, T _eps) : m(_x.size()){
+        assert(_dt > T());
+        this->itrmax = _itrmax;
+        this->eps = _eps;
+        this->phifixed = _phifixed;
+
+        //----------Number free nodes----------
+        this->nodetoglobal = std::vector<std::vector<int> >(this->m, std::vector<int>(1, 0));
+        SetDirichlet(this->nodetoglobal, _phifixed);
+        int KDEGREE = Renumbering(this->nodetoglobal);
+
+        //----------Assemble operators once----------
+        LILCSR<T> A = LILCSR<T>(KDEGREE, KDEGREE), B = LILCSR<T>(KDEGREE, this->m), MF = LILCSR<T>(KDEGREE, this->m);
+        for(auto& element : _elements){
+            Matrix<T> Me, Ke;
+            std::vector<std::vector<std::pair<int, int> > > nodetoelement;
+            ReactionDiffusionConsistentMass<T, SF, IC>(Me, nodetoelement, element, { 0 }, _x);
+            ReactionDiffusionStiffness<T, SF, IC>(Ke, nodetoelement, element, { 0 }, _x, _D);
+            for(int i = 0; i < element.size(); i++){
+                int globali = this->nodetoglobal[element[i]][0];
+                if(globali != -1){
+                    for(int j = 0; j < element.size(); j++){
+                        int globalj = this->nodetoglobal[element[j]][0];
+                        if(globalj != -1){
+                            A.set(globali, globalj, A.get(globali, globalj) + Me(i, j)/_dt + Ke(i, j));
+                            B.set(globali, element[j], B.get(globali, element[j]) + Me(i, j)/_dt);
+                        } else {
+                            B.set(globali, element[j], B.get(globali, element[j]) - Ke(i, j));
+                        }
+                        MF.set(globali, element[j], MF.get(globali, element[j]) + Me(i, j));
+                    }
+                }
+            }
+        }
+        this->A = CSR<T>(A);
+        this->ILU = ILU0(this->A);
+        this->B = CSR<T>(B);
+        this->MF = CSR<T>(MF);
+    }
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    LevelSet<T, SF, IC>::~LevelSet(){}
+
+
+    template<class T, template<class>class SF, template<class>class IC>
+    void LevelSet<T, SF, IC>::UpdateLevelSet(std::vector<Vector<T> >& _phi, const std::vector<Vector<T> >& _TD, T _C, T _lambda){
+        assert(_phi.size() == this->m && _TD.size() == this->m);
+        for(auto& phifixedi : this->phifixed){
+            _phi[phifixedi.first.first](phifixedi.first.second) = phifixedi.second;
+        }
+
+        //----------Get right hand side with constant operators----------
+        std::vector<T> phi = std::vector<T>(this->m), TD = std::vector<T>(this->m);
+        for(int i = 0; i < this->m; i++){
+            phi[i] = _phi[i](0);
+            TD[i] = _C*(_TD[i](0) - _lambda);
+        }
+        std::vector<T> Y, R;
+        this->B.multiply(phi, Y);
+        this->MF.multiply(TD, R);
+        xexpay(Y, 1.0, R);
+
+        //----------Solve with previous phi as initial guess----------
+        std::vector<T> phi0 = std::vector<T>(this->A.ROWS);
+        for(int i = 0; i < this->m; i++){
+            if(this->nodetoglobal[i][0] != -1){
+                phi0[this->nodetoglobal[i][0]] = phi[i];
+            }
+        }
+        std::vector<T> result = ILU0CG(this->A, this->ILU, Y, this->itrmax, this->eps, phi0);
+        Disassembling(_phi, result, this->nodetoglobal);
+
+        for(auto& phii : _phi){
+            phii(0) = std::max(std::min((T)1.0, phii(0)), (T)-1.0);
+        }
+    }
+}
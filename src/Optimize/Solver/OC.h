@@ -66,7 +66,7 @@ private:
 
     template<class T>
     bool OC<T>::IsConvergence(T _currentf0){
-        if(fabs(_currentf0 - this->previousvalue)/(_currentf0 + this->previousvalue) < this->epsvalue){
+        if(fabs(_currentf0 - this->previousvalue)/(fabs(_currentf0) + fabs(this->previousvalue)) < this->epsvalue){
             return true;
         } 
         return false;
@@ -0,0 +1,466 @@
+//*****************************************************************************
+//  Title       :src/Optimize/Solver/SeparableSubproblem.h
+//  Author      :Tanabe Yuta
+//  Date        :2026/10/19
+//  Copyright   :(C)2020 TanabeYuta
+//*****************************************************************************
+
+
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+#include <numeric>
+
+
+#include "../../LinearAlgebra/Models/Matrix.h"
+#include "../../LinearAlgebra/Models/Vector.h"
+#include "../../LinearAlgebra/Solvers/Cholesky.h"
+
+
+namespace PANSFEM2{
+    //********************Primal-dual interior point solver of separable convex subproblem********************
+    //  min     sum_j (p0_j*phi_j(x_j) + q0_j*psi_j(x_j)) + a0*z + sum_i (c_i*y_i + 0.5*d_i*y_i^2)
+    //  s.t.    sum_j (p_ij*phi_j(x_j) + q_ij*psi_j(x_j)) - a_i*z - y_i <= b_i
+    //          alpha_j <= x_j <= beta_j, y_i >= 0, z >= 0
+    //  which is common to MMA (phi = 1/(U - x), psi = 1/(x - L)) and CONLIN (phi = x, psi = 1/x).
+    //  Set alpha, beta, p0, q0, p (p[i*n + j]), q and b, then call Solve with
+    //  _basis(j, x, phi, psi) giving values, first and second derivatives of phi_j and psi_j at x.
+    //  Newton system is reduced to m + 1 unknowns (dual form) if m < n, otherwise to n + 1 unknowns
+    //  (primal form). Both are solved with parallel Cholesky decomposition.
+    template<class T>
+    class SeparableSubproblem{
+public:
+        SeparableSubproblem();
+        SeparableSubproblem(int _n, int _m, T _a0, const std::vector<T>& _a, const std::vector<T>& _c, const std::vector<T>& _d);
+
+
+        std::vector<T> alpha;   //  Movelimit
+        std::vector<T> beta;    //  Movelimit
+        std::vector<T> p0;      //  Coefficients of objective
+        std::vector<T> q0;      //  Coefficients of objective
+        std::vector<T> p;       //  Coefficients of constraints (p[i*n + j] for constraint i and variable j)
+        std::vector<T> q;       //  Coefficients of constraints (q[i*n + j] for constraint i and variable j)
+        std::vector<T> b;       //  Right hand side of constraints
+
+
+        template<class F>
+        void Solve(F _basis, std::vector<T>& _x);
+
+
+private:
+        int n;                  //  Number of design variables
+        int m;                  //  Number of constraint
+        T a0;                   //  Used in equation(3.1)
+        std::vector<T> a;       //  Used in equation(3.1)
+        std::vector<T> c;       //  Used in equation(3.1)
+        std::vector<T> d;       //  Used in equation(3.1)
+
+
+        //----------Workspace----------
+        std::vector<T> x, gsi, ita, dx, dgsi, dita, xnew, gsinew, itanew;
+        std::vector<T> G;       //  Derivative of constraints (G[i*n + j])
+        std::vector<T> Dx1;     //  Inverse of diagonal Dx
+        std::vector<T> deltilx;
+
+
+        template<class F>
+        T KKTNorm(F _basis, const std::vector<T>& _x, const std::vector<T>& _y, T _z, const std::vector<T>& _lambda, const std::vector<T>& _gsi, const std::vector<T>& _ita, const std::vector<T>& _mu, T _zeta, const std::vector<T>& _s, T _eps);
+    };
+
+
+    template<class T>
+    SeparableSubproblem<T>::SeparableSubproblem(){
+        this->n = 0;
+        this->m = 0;
+        this->a0 = T();
+    }
+
+
+    template<class T>
+    SeparableSubproblem<T>::SeparableSubproblem(int _n, int _m, T _a0, const std::vector<T>& _a, const std::vector<T>& _c, const std::vector<T>& _d){
+        assert(_a.size() == _m && _c.size() == _m && _d.size() == _m);
+        this->n = _n;
+        this->m = _m;
+        this->a0 = _a0;
+        this->a = _a;
+        this->c = _c;
+        this->d = _d;
+
+        this->alpha = std::vector<T>(this->n);
+        this->beta = std::vector<T>(this->n);
+        this->p0 = std::vector<T>(this->n);
+        this->q0 = std::vector<T>(this->n);
+        this->p = std::vector<T>(this->m*this->n);
+        this->q = std::vector<T>(this->m*this->n);
+        this->b = std::vector<T>(this->m);
+
+        this->x = std::vector<T>(this->n);
+        this->gsi = std::vector<T>(this->n);
+        this->ita = std::vector<T>(this->n);
+        this->dx = std::vector<T>(this->n);
+        this->dgsi = std::vector<T>(this->n);
+        this->dita = std::vector<T>(this->n);
+        this->xnew = std::vector<T>(this->n);
+        this->gsinew = std::vector<T>(this->n);
+        this->itanew = std::vector<T>(this->n);
+        this->G = std::vector<T>(this->m*this->n);
+        this->Dx1 = std::vector<T>(this->n);
+        this->deltilx = std::vector<T>(this->n);
+    }
+
+
+    template<class T>
+    template<class F>
+    void SeparableSubproblem<T>::Solve(F _basis, std::vector<T>& _x){
+        const int BLOCKSIZE = 256;      //  Number of design variables in a block of dual form
+
+        T eps = 1.0;
+        std::vector<T> y = std::vector<T>(this->m, 1.0);
+        T z = 1.0;
+        T zeta = 1.0;
+        std::vector<T> lambda = std::vector<T>(this->m, 1.0);
+        std::vector<T> s = std::vector<T>(this->m, 1.0);
+        std::vector<T> mu = std::vector<T>(this->m);
+
+        for(int i = 0; i < this->m; i++){
+            mu[i] = std::max(1.0, 0.5*this->c[i]);
+        }
+
+#pragma omp parallel for
+        for(int j = 0; j < this->n; j++){
+            this->x[j] = 0.5*(this->alpha[j] + this->beta[j]);
+            this->gsi[j] = std::max(1.0, 1.0/(this->x[j] - this->alpha[j]));
+            this->ita[j] = std::max(1.0, 1.0/(this->beta[j] - this->x[j]));
+        }
+
+        std::vector<T> Dy = std::vector<T>(this->m);
+        std::vector<T> deltily = std::vector<T>(this->m);
+        std::vector<T> deltillambda = std::vector<T>(this->m);
+        std::vector<T> Dlambday = std::vector<T>(this->m);
+        std::vector<T> deltillambday = std::vector<T>(this->m);
+        std::vector<T> dy = std::vector<T>(this->m);
+        std::vector<T> dlambda = std::vector<T>(this->m);
+        std::vector<T> dmu = std::vector<T>(this->m);
+        std::vector<T> ds = std::vector<T>(this->m);
+        std::vector<T> ypdy = std::vector<T>(this->m);
+        std::vector<T> lambdapdlambda = std::vector<T>(this->m);
+        std::vector<T> mupdmu = std::vector<T>(this->m);
+        std::vector<T> spds = std::vector<T>(this->m);
+
+        T deltawl = this->KKTNorm(_basis, this->x, y, z, lambda, this->gsi, this->ita, mu, zeta, s, eps);
+        for(int l = 0; eps > 1.0e-7; l++){
+            //.....Get coefficients.....
+            std::fill(deltillambda.begin(), deltillambda.end(), T());
+#pragma omp parallel
+            {
+                std::vector<T> gthread = std::vector<T>(this->m, T());
+#pragma omp for
+                for(int j = 0; j < this->n; j++){
+                    T phi[3], psi[3];
+                    _basis(j, this->x[j], phi, psi);
+                    T xa = 1.0/(this->x[j] - this->alpha[j]);
+                    T bx = 1.0/(this->beta[j] - this->x[j]);
+                    T plambda = this->p0[j];
+                    T qlambda = this->q0[j];
+                    for(int i = 0; i < this->m; i++){
+                        T pij = this->p[i*this->n + j];
+                        T qij = this->q[i*this->n + j];
+                        plambda += lambda[i]*pij;
+                        qlambda += lambda[i]*qij;
+                        this->G[i*this->n + j] = pij*phi[1] + qij*psi[1];
+                        gthread[i] += pij*phi[0] + qij*psi[0];
+                    }
+                    this->Dx1[j] = 1.0/(plambda*phi[2] + qlambda*psi[2] + this->gsi[j]*xa + this->ita[j]*bx);
+                    this->deltilx[j] = plambda*phi[1] + qlambda*psi[1] - eps*xa + eps*bx;
+                }
+#pragma omp critical
+                {
+                    for(int i = 0; i < this->m; i++){
+                        deltillambda[i] += gthread[i];
+                    }
+                }
+            }
+
+            for(int i = 0; i < this->m; i++){
+                Dy[i] = this->d[i] + mu[i]/y[i];
+                deltily[i] = this->c[i] + this->d[i]*y[i] - lambda[i] - eps/y[i];
+                deltillambda[i] += -this->a[i]*z - y[i] - this->b[i] + eps/lambda[i];
+                Dlambday[i] = s[i]/lambda[i] + 1.0/Dy[i];
+                deltillambday[i] = deltillambda[i] + deltily[i]/Dy[i];
+            }
+
+            T deltilz = this->a0 - eps/z - std::inner_product(lambda.begin(), lambda.end(), this->a.begin(), T());
+
+            //.....Get Newton direction.....
+            T dz = T();
+            if(this->m < this->n){
+                //  Dual form : (G*Dx^-1*G^T + Dlambday)*dlambda + a*dz = deltillambday - G*Dx^-1*deltilx
+                //              a^T*dlambda - zeta/z*dz = deltilz
+                Matrix<T> A = Matrix<T>(this->m, this->m);
+                Vector<T> B = Vector<T>(this->m);
+#pragma omp parallel
+                {
+                    std::vector<T> Athread = std::vector<T>(this->m*this->m, T());
+                    std::vector<T> Bthread = std::vector<T>(this->m, T());
+                    std::vector<T> GDii = std::vector<T>(BLOCKSIZE);
+#pragma omp for
+                    for(int jbegin = 0; jbegin < this->n; jbegin += BLOCKSIZE){
+                        int jsize = std::min(BLOCKSIZE, this->n - jbegin);
+                        for(int ii = 0; ii < this->m; ii++){
+                            //  Row ii of G*Dx^-1 in this block is reused for all jj
+                            const T* Gii = &this->G[ii*this->n + jbegin];
+                            T GDdeltilxi = T();
+                            for(int j = 0; j < jsize; j++){
+                                GDii[j] = Gii[j]*this->Dx1[jbegin + j];
+                                GDdeltilxi += GDii[j]*this->deltilx[jbegin + j];
+                            }
+                            Bthread[ii] -= GDdeltilxi;
+
+                            //  4 rows of G at once to load GDii once for 4 products
+                            int jj = 0;
+                            for(; jj + 3 <= ii; jj += 4){
+                                const T* G0 = &this->G[jj*this->n + jbegin];
+                                const T* G1 = G0 + this->n;
+                                const T* G2 = G1 + this->n;
+                                const T* G3 = G2 + this->n;
+                                T GDG0 = T(), GDG1 = T(), GDG2 = T(), GDG3 = T();
+#pragma omp simd reduction(+:GDG0,GDG1,GDG2,GDG3)
+                                for(int j = 0; j < jsize; j++){
+                                    GDG0 += GDii[j]*G0[j];
+                                    GDG1 += GDii[j]*G1[j];
+                                    GDG2 += GDii[j]*G2[j];
+                                    GDG3 += GDii[j]*G3[j];
+                                }
+                                Athread[ii*this->m + jj] += GDG0;
+                                Athread[ii*this->m + jj + 1] += GDG1;
+                                Athread[ii*this->m + jj + 2] += GDG2;
+                                Athread[ii*this->m + jj + 3] += GDG3;
+                            }
+                            for(; jj <= ii; jj++){
+                                const T* Gjj = &this->G[jj*this->n + jbegin];
+                                T GDGij = T();
+#pragma omp simd reduction(+:GDGij)
+                                for(int j = 0; j < jsize; j++){
+                                    GDGij += GDii[j]*Gjj[j];
+                                }
+                                Athread[ii*this->m + jj] += GDGij;
+                            }
+                        }
+                    }
+#pragma omp critical
+                    {
+                        for(int ii = 0; ii < this->m; ii++){
+                            for(int jj = 0; jj <= ii; jj++){
+                                A(ii, jj) += Athread[ii*this->m + jj];
+                            }
+                            B(ii) += Bthread[ii];
+                        }
+                    }
+                }
+                Vector<T> Va = Vector<T>(this->a);
+                for(int ii = 0; ii < this->m; ii++){
+                    A(ii, ii) += Dlambday[ii];
+                    B(ii) += deltillambday[ii];
+                }
+
+                //  Eliminate dz with A^-1*B and A^-1*a
+                Cholesky(A);
+                SolveCholesky(A, B);
+                SolveCholesky(A, Va);
+                T aAB = T(), aAa = T();
+                for(int i = 0; i < this->m; i++){
+                    aAB += this->a[i]*B(i);
+                    aAa += this->a[i]*Va(i);
+                }
+                dz = (aAB - deltilz)/(aAa + zeta/z);
+                for(int i = 0; i < this->m; i++){
+                    dlambda[i] = B(i) - Va(i)*dz;
+                }
+
+#pragma omp parallel for
+                for(int j = 0; j < this->n; j++){
+                    T Gdlambda = this->deltilx[j];
+                    for(int i = 0; i < this->m; i++){
+                        Gdlambda += this->G[i*this->n + j]*dlambda[i];
+                    }
+                    this->dx[j] = -Gdlambda*this->Dx1[j];
+                }
+            } else {
+                //  Primal form : [Dx + G^T*Dlambday^-1*G, -G^T*Dlambday^-1*a; sym., zeta/z + a^T*Dlambday^-1*a]*[dx; dz] = [-deltilx - G^T*Dlambday^-1*deltillambday; -deltilz + a^T*Dlambday^-1*deltillambday]
+                int size = this->n + 1;
+                Matrix<T> A = Matrix<T>(size, size);
+                Vector<T> B = Vector<T>(size);
+                std::vector<T> Dlambday1 = std::vector<T>(this->m);
+                for(int i = 0; i < this->m; i++){
+                    Dlambday1[i] = 1.0/Dlambday[i];
+                }
+#pragma omp parallel for schedule(dynamic)
+                for(int ii = 0; ii < this->n; ii++){
+                    T* Aii = &A(ii, 0);
+                    T Ain = T();
+                    T Bi = -this->deltilx[ii];
+                    for(int kk = 0; kk < this->m; kk++){
+                        const T* Gkk = &this->G[kk*this->n];
+                        T GDkk = Gkk[ii]*Dlambday1[kk];
+#pragma omp simd
+                        for(int jj = 0; jj <= ii; jj++){
+                            Aii[jj] += GDkk*Gkk[jj];
+                        }
+                        Ain -= GDkk*this->a[kk];
+                        Bi -= GDkk*deltillambday[kk];
+                    }
+                    Aii[ii] += 1.0/this->Dx1[ii];
+                    A(this->n, ii) = Ain;
+                    B(ii) = Bi;
+                }
+                A(this->n, this->n) = zeta/z;
+                B(this->n) = -deltilz;
+                for(int kk = 0; kk < this->m; kk++){
+                    A(this->n, this->n) += this->a[kk]*this->a[kk]*Dlambday1[kk];
+                    B(this->n) += this->a[kk]*deltillambday[kk]*Dlambday1[kk];
+                }
+
+                Cholesky(A);
+                SolveCholesky(A, B);
+                for(int j = 0; j < this->n; j++){
+                    this->dx[j] = B(j);
+                }
+                dz = B(this->n);
+                for(int i = 0; i < this->m; i++){
+                    const T* Gi = &this->G[i*this->n];
+                    T Gdx = T();
+                    for(int j = 0; j < this->n; j++){
+                        Gdx += Gi[j]*this->dx[j];
+                    }
+                    dlambda[i] = (Gdx - this->a[i]*dz + deltillambday[i])*Dlambday1[i];
+                }
+            }
+
+            for(int i = 0; i < this->m; i++){
+                dy[i] = dlambda[i]/Dy[i] - deltily[i]/Dy[i];
+                dmu[i] = -mu[i]*dy[i]/y[i] - mu[i] + eps/y[i];
+                ds[i] = -s[i]*dlambda[i]/lambda[i] - s[i] + eps/lambda[i];
+            }
+
+            T dzeta = -zeta*dz/z - zeta + eps/z;
+
+            //.....Get step size.....
+            T txmax = T();
+#pragma omp parallel for reduction(max:txmax)
+            for(int j = 0; j < this->n; j++){
+                T xa = this->x[j] - this->alpha[j];
+                T bx = this->beta[j] - this->x[j];
+                this->dgsi[j] = -this->gsi[j]*this->dx[j]/xa - this->gsi[j] + eps/xa;
+                this->dita[j] = this->ita[j]*this->dx[j]/bx - this->ita[j] + eps/bx;
+                txmax = std::max({txmax, -1.01*this->dx[j]/xa, 1.01*this->dx[j]/bx, -1.01*this->dgsi[j]/this->gsi[j], -1.01*this->dita[j]/this->ita[j]});
+            }
+            T tymax = T();
+            for(int i = 0; i < this->m; i++){
+                tymax = std::max({tymax, -1.01*dy[i]/y[i], -1.01*dlambda[i]/lambda[i], -1.01*dmu[i]/mu[i], -1.01*ds[i]/s[i]});
+            }
+            T tau = 1.0/std::max({1.0, txmax, tymax, -1.01*dz/z, -1.01*dzeta/zeta});
+            T zpdz;
+            T zetapdzeta;
+            T deltawlp1;
+            for(int ll = 0; ll < 50; ll++){
+#pragma omp parallel for
+                for(int j = 0; j < this->n; j++){
+                    this->xnew[j] = this->x[j] + tau*this->dx[j];
+                    this->gsinew[j] = this->gsi[j] + tau*this->dgsi[j];
+                    this->itanew[j] = this->ita[j] + tau*this->dita[j];
+                }
+                for(int i = 0; i < this->m; i++){
+                    ypdy[i] = y[i] + tau*dy[i];
+                    lambdapdlambda[i] = lambda[i] + tau*dlambda[i];
+                    mupdmu[i] = mu[i] + tau*dmu[i];
+                    spds[i] = s[i] + tau*ds[i];
+                }
+                zpdz = z + tau*dz;
+                zetapdzeta = zeta + tau*dzeta;
+
+                deltawlp1 = this->KKTNorm(_basis, this->xnew, ypdy, zpdz, lambdapdlambda, this->gsinew, this->itanew, mupdmu, zetapdzeta, spds, eps);
+                if(deltawlp1 < deltawl){
+                    break;
+                }
+                tau *= 0.5;
+            }
+
+            //.....Update w.....
+            std::swap(this->x, this->xnew);
+            std::swap(this->gsi, this->gsinew);
+            std::swap(this->ita, this->itanew);
+            std::swap(y, ypdy);
+            z = zpdz;
+            std::swap(lambda, lambdapdlambda);
+            std::swap(mu, mupdmu);
+            zeta = zetapdzeta;
+            std::swap(s, spds);
+
+            //.....Update epsl.....
+            if(deltawlp1 < 0.9*eps){
+                eps *= 0.1;
+                deltawl = this->KKTNorm(_basis, this->x, y, z, lambda, this->gsi, this->ita, mu, zeta, s, eps);
+            } else {
+                deltawl = deltawlp1;
+            }
+        }
+
+        _x = this->x;
+    }
+
+
+    template<class T>
+    template<class F>
+    T SeparableSubproblem<T>::KKTNorm(F _basis, const std::vector<T>& _x, const std::vector<T>& _y, T _z, const std::vector<T>& _lambda, const std::vector<T>& _gsi, const std::vector<T>& _ita, const std::vector<T>& _mu, T _zeta, const std::vector<T>& _s, T _eps){
+        T norm = T();
+        std::vector<T> g = std::vector<T>(this->m, T());
+
+        //----------Equation(5.9a)(5.9e)(5.9f)----------
+#pragma omp parallel
+        {
+            T normthread = T();
+            std::vector<T> gthread = std::vector<T>(this->m, T());
+#pragma omp for
+            for(int j = 0; j < this->n; j++){
+                T phi[3], psi[3];
+                _basis(j, _x[j], phi, psi);
+                T plambda = this->p0[j];
+                T qlambda = this->q0[j];
+                for(int i = 0; i < this->m; i++){
+                    T pij = this->p[i*this->n + j];
+                    T qij = this->q[i*this->n + j];
+                    plambda += _lambda[i]*pij;
+                    qlambda += _lambda[i]*qij;
+                    gthread[i] += pij*phi[0] + qij*psi[0];
+                }
+                T r0 = plambda*phi[1] + qlambda*psi[1] - _gsi[j] + _ita[j];     //  Equation(5.9a)
+                T r1 = _gsi[j]*(_x[j] - this->alpha[j]) - _eps;                 //  Equation(5.9e)
+                T r2 = _ita[j]*(this->beta[j] - _x[j]) - _eps;                  //  Equation(5.9f)
+                normthread += r0*r0 + r1*r1 + r2*r2;
+            }
+#pragma omp critical
+            {
+                for(int i = 0; i < this->m; i++){
+                    g[i] += gthread[i];
+                }
+                norm += normthread;
+            }
+        }
+
+        //----------Equation(5.9b)(5.9d)(5.9g)(5.9i)----------
+        for(int i = 0; i < this->m; i++){
+            norm += pow(this->c[i] + this->d[i]*_y[i] - _lambda[i] - _mu[i], 2.0);      //  Equation(5.9b)
+            norm += pow(g[i] - this->a[i]*_z - _y[i] + _s[i] - this->b[i], 2.0);        //  Equation(5.9d)
+            norm += pow(_mu[i]*_y[i] - _eps, 2.0);                                      //  Equation(5.9g)
+            norm += pow(_lambda[i]*_s[i] - _eps, 2.0);                                  //  Equation(5.9i)
+        }
+
+        //----------Equation(5.9c)(5.9h)----------
+        norm += pow(this->a0 - _zeta - std::inner_product(_lambda.begin(), _lambda.end(), this->a.begin(), T()), 2.0);      //  Equation(5.9c)
+        norm += pow(_zeta*_z - _eps, 2.0);                                                                                  //  Equation(5.9h)
+
+        return sqrt(norm);
+    }
+}